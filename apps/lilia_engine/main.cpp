@@ -1,7 +1,26 @@
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+#include "lilia/engine/bench.hpp"
 #include "lilia/protocol/uci/uci.hpp"
 
-int main()
+int main(int argc, char **argv)
 {
+  // lilia_engine bench [depth] [threads] [hashMb]: one-shot benchmark (also the PGO training run)
+  if (argc > 1 && std::string_view(argv[1]) == "bench")
+  {
+    lilia::engine::BenchOptions opt;
+    if (argc > 2)
+      opt.depth = std::atoi(argv[2]);
+    if (argc > 3)
+      opt.threads = std::atoi(argv[3]);
+    if (argc > 4)
+      opt.hashMb = static_cast<std::size_t>(std::atoll(argv[4]));
+    (void)lilia::engine::run_bench(std::cout, opt);
+    return 0;
+  }
+
   lilia::protocol::uci::UCI uci;
   return uci.run();
 }
@@ -0,0 +1,71 @@
+// lilia_perft: move generator throughput and correctness.
+//
+//   lilia_perft                         run the standard suite, exit 1 on a count mismatch
+//   lilia_perft <depth> [options]       perft of one position
+//
+// options: --fen "<fen>"  --divide  --threads N  --hash MB  --no-bulk  --suite
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "lilia/chess/chess_constants.hpp"
+#include "lilia/chess/chess_game.hpp"
+#include "lilia/engine/engine.hpp"
+#include "lilia/engine/perft.hpp"
+#include "lilia/protocol/uci/uci_helper.hpp"
+
+int main(int argc, char **argv)
+{
+  using namespace lilia;
+
+  engine::Engine::init();
+
+  engine::PerftOptions opt;
+  std::string fen{chess::constant::START_FEN};
+  int depth = 0;
+  bool divide = false;
+  bool suite = false;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--fen" && i + 1 < argc)
+      fen = argv[++i];
+    else if (arg == "--divide")
+      divide = true;
+    else if (arg == "--threads" && i + 1 < argc)
+      opt.threads = std::atoi(argv[++i]);
+    else if (arg == "--hash" && i + 1 < argc)
+      opt.hashMb = static_cast<std::size_t>(std::atoll(argv[++i]));
+    else if (arg == "--no-bulk")
+      opt.bulk = false;
+    else if (arg == "--suite")
+      suite = true;
+    else if (!arg.empty() && arg[0] != '-')
+      depth = std::atoi(arg.c_str());
+    else
+    {
+      std::cerr << "usage: lilia_perft [depth] [--fen FEN] [--divide] [--threads N] [--hash MB]"
+                   " [--no-bulk] [--suite]\n";
+      return 2;
+    }
+  }
+
+  if (suite || depth <= 0)
+    return engine::run_perft_suite(std::cout, opt, depth) ? 0 : 1;
+
+  chess::ChessGame game;
+  game.setPosition(fen);
+  const engine::PerftResult r = engine::perft(game.getPositionRefForBot(), depth, opt);
+
+  if (divide)
+  {
+    for (const auto &d : r.divide)
+      std::cout << protocol::uci::move_to_uci(d.move) << ": " << d.nodes << "\n";
+    std::cout << "\n";
+  }
+  const std::uint64_t nps = r.elapsedMs ? r.nodes * 1000 / r.elapsedMs : r.nodes;
+  std::cout << "Nodes searched: " << r.nodes << "\n"
+            << "Time: " << r.elapsedMs << " ms, nps " << nps << "\n";
+  return 0;
+}
@@ -0,0 +1,560 @@
+// lilia_microbench: per-kernel timings over a corpus of real positions.
+//
+//   lilia_microbench [filter...] [--min-time MS] [--reps N] [--list]
+//
+// Each benchmark is one pass of its kernel over the corpus (the `bench` positions plus
+// seeded random walks from them), repeated until a run lasts at least --min-time; the
+// best of --reps runs is reported as ns/op and cycles/op. Cycles are TSC reference
+// cycles (x86 only), so they scale with the nominal clock, not with turbo.
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "lilia/chess/chess_game.hpp"
+#include "lilia/chess/core/magic.hpp"
+#include "lilia/chess/move_buffer.hpp"
+#include "lilia/chess/move_generator.hpp"
+#include "lilia/engine/bench.hpp"
+#include "lilia/engine/engine.hpp"
+#include "lilia/engine/eval.hpp"
+#include "lilia/engine/move_list.hpp"
+#include "lilia/engine/move_order.hpp"
+#include "lilia/engine/search_position.hpp"
+#include "lilia/engine/see.hpp"
+#include "lilia/engine/transposition_table.hpp"
+
+using namespace lilia;
+
+namespace
+{
+  using steady_clock = std::chrono::steady_clock;
+
+  constexpr int WALKS_PER_ROOT = 8;
+  constexpr int MAX_WALK_PLIES = 12;
+  constexpr std::uint64_t CORPUS_SEED = 0x9E3779B97F4A7C15ull;
+
+  // ---- timing ----
+
+  LILIA_ALWAYS_INLINE std::uint64_t read_cycles()
+  {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+  }
+
+  template <class T>
+  LILIA_ALWAYS_INLINE void keep(const T &v)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(v) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &v;
+#endif
+  }
+
+  struct Xorshift
+  {
+    std::uint64_t s;
+    std::uint64_t next()
+    {
+      s ^= s << 13;
+      s ^= s >> 7;
+      s ^= s << 17;
+      return s;
+    }
+  };
+
+  // ---- corpus ----
+
+  struct Corpus
+  {
+    std::vector<chess::Position> positions;
+    std::vector<std::unique_ptr<engine::SearchPosition>> searchPositions;
+    std::vector<std::vector<chess::Move>> legal;  // per position
+    std::vector<std::size_t> inCheck;             // indices of positions in check
+  };
+
+  Corpus build_corpus()
+  {
+    Corpus c;
+    chess::MoveGenerator mg;
+    Xorshift rng{CORPUS_SEED};
+
+    for (const char *fen : engine::bench_positions())
+    {
+      chess::ChessGame game;
+      game.setPosition(fen);
+      const chess::Position root = game.getPositionRefForBot();
+      c.positions.push_back(root);
+
+      for (int w = 0; w < WALKS_PER_ROOT; ++w)
+      {
+        chess::Position p = root;
+        std::array<chess::StateInfo, MAX_WALK_PLIES> st{};
+        const int plies = 1 + static_cast<int>(rng.next() % MAX_WALK_PLIES);
+        int played = 0;
+        for (; played < plies; ++played)
+        {
+          std::vector<chess::Move> moves;
+          mg.generateLegalMoves(p.getBoard(), p.getState(), moves);
+          if (moves.empty())
+            break;
+          p.doLegalMove(moves[rng.next() % moves.size()], st[played]);
+        }
+        if (played > 0)
+          c.positions.push_back(p); // copying flattens the StateInfo chain
+      }
+    }
+
+    for (std::size_t i = 0; i < c.positions.size(); ++i)
+    {
+      const chess::Position &p = c.positions[i];
+      c.searchPositions.push_back(std::make_unique<engine::SearchPosition>(p));
+      auto &moves = c.legal.emplace_back();
+      mg.generateLegalMoves(p.getBoard(), p.getState(), moves);
+      if (p.inCheck())
+        c.inCheck.push_back(i);
+    }
+    return c;
+  }
+
+  // ---- registry / runner ----
+
+  // Runs one pass over the kernel's input and returns the number of ops performed.
+  using Kernel = std::function<std::uint64_t()>;
+
+  struct Benchmark
+  {
+    std::string name;
+    Kernel pass;
+    std::function<void()> setup; // optional, runs before every timed run
+  };
+
+  struct Options
+  {
+    std::vector<std::string> filters;
+    int minTimeMs = 200;
+    int reps = 3;
+    bool list = false;
+  };
+
+  bool selected(const Options &opt, std::string_view name)
+  {
+    if (opt.filters.empty())
+      return true;
+    return std::any_of(opt.filters.begin(), opt.filters.end(),
+                       [&](const std::string &f) { return name.find(f) != std::string_view::npos; });
+  }
+
+  void run(const Options &opt, const Benchmark &b)
+  {
+    using namespace std::chrono;
+
+    // Calibrate the pass count to the requested run time.
+    std::uint64_t passes = 1;
+    for (;;)
+    {
+      if (b.setup)
+        b.setup();
+      const auto t0 = steady_clock::now();
+      for (std::uint64_t i = 0; i < passes; ++i)
+        keep(b.pass());
+      const auto ms = duration_cast<milliseconds>(steady_clock::now() - t0).count();
+      if (ms * 4 >= opt.minTimeMs || passes >= (1ull << 30))
+      {
+        if (ms > 0 && ms < opt.minTimeMs)
+          passes = passes * static_cast<std::uint64_t>(opt.minTimeMs) / static_cast<std::uint64_t>(ms) + 1;
+        break;
+      }
+      passes *= 2;
+    }
+
+    double bestNs = 0.0, bestCycles = 0.0;
+    std::uint64_t ops = 0;
+    for (int r = 0; r < std::max(1, opt.reps); ++r)
+    {
+      if (b.setup)
+        b.setup();
+      ops = 0;
+      const auto t0 = steady_clock::now();
+      const std::uint64_t c0 = read_cycles();
+      for (std::uint64_t i = 0; i < passes; ++i)
+        ops += b.pass();
+      const std::uint64_t c1 = read_cycles();
+      const auto ns = duration_cast<nanoseconds>(steady_clock::now() - t0).count();
+
+      if (ops == 0)
+        break;
+      const double nsOp = static_cast<double>(ns) / static_cast<double>(ops);
+      const double cyOp = static_cast<double>(c1 - c0) / static_cast<double>(ops);
+      if (r == 0 || nsOp < bestNs)
+      {
+        bestNs = nsOp;
+        bestCycles = cyOp;
+      }
+    }
+
+    std::cout << std::left << std::setw(28) << b.name << std::right << std::setw(14) << ops;
+    if (ops == 0)
+    {
+      std::cout << "   (no input)\n";
+      return;
+    }
+    std::cout << std::fixed << std::setprecision(2) << std::setw(12) << bestNs;
+    if (read_cycles() != 0)
+      std::cout << std::setw(12) << bestCycles;
+    else
+      std::cout << std::setw(12) << "n/a";
+    std::cout << "\n";
+  }
+}
+
+int main(int argc, char **argv)
+{
+  Options opt;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--min-time" && i + 1 < argc)
+      opt.minTimeMs = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--reps" && i + 1 < argc)
+      opt.reps = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--list")
+      opt.list = true;
+    else if (!arg.empty() && arg[0] != '-')
+      opt.filters.push_back(arg);
+    else
+    {
+      std::cerr << "usage: lilia_microbench [filter...] [--min-time MS] [--reps N] [--list]\n";
+      return 2;
+    }
+  }
+
+  engine::Engine::init();
+  const Corpus corpus = build_corpus();
+  chess::MoveGenerator mg;
+  Xorshift rng{CORPUS_SEED ^ 0xABCDEFull};
+
+  std::vector<Benchmark> benches;
+
+  // ---- evaluation ----
+  engine::Evaluator evaluator;
+  benches.push_back({"eval", [&]
+                     {
+                       int acc = 0;
+                       for (const auto &sp : corpus.searchPositions)
+                         acc += evaluator.evaluate(*sp);
+                       keep(acc);
+                       return corpus.searchPositions.size();
+                     }});
+  benches.push_back({"eval/cold-pawn-hash", [&]
+                     {
+                       int acc = 0;
+                       for (const auto &sp : corpus.searchPositions)
+                       {
+                         evaluator.clearPawnHash();
+                         acc += evaluator.evaluate(*sp);
+                       }
+                       keep(acc);
+                       return corpus.searchPositions.size();
+                     }});
+
+  // ---- SEE ----
+  struct SeeCase
+  {
+    std::size_t pos;
+    chess::Move move;
+  };
+  std::vector<SeeCase> seeCases;
+  for (std::size_t i = 0; i < corpus.positions.size(); ++i)
+    for (const chess::Move &m : corpus.legal[i])
+      if (m.isCapture())
+        seeCases.push_back({i, m});
+  benches.push_back({"see_ge", [&]
+                     {
+                       int acc = 0;
+                       for (const SeeCase &c : seeCases)
+                         acc += engine::see::see_ge_impl(corpus.positions[c.pos], c.move, 0);
+                       keep(acc);
+                       return seeCases.size();
+                     }});
+
+  // ---- slider lookups ----
+  struct SliderQuery
+  {
+    chess::magic::Slider s;
+    chess::Square sq;
+    chess::bb::Bitboard occ;
+  };
+  std::vector<SliderQuery> sliderQueries;
+  for (const chess::Position &p : corpus.positions)
+  {
+    const chess::Board &b = p.getBoard();
+    const chess::bb::Bitboard occ = b.getAllPieces();
+    for (chess::Color c : {chess::Color::White, chess::Color::Black})
+    {
+      const chess::bb::Bitboard q = b.getPieces(c, chess::PieceType::Queen);
+      chess::bb::Bitboard rooks = b.getPieces(c, chess::PieceType::Rook) | q;
+      chess::bb::Bitboard bishops = b.getPieces(c, chess::PieceType::Bishop) | q;
+      for (; rooks; rooks &= rooks - 1)
+        sliderQueries.push_back({chess::magic::Slider::Rook,
+                                 static_cast<chess::Square>(chess::bb::ctz64(rooks)), occ});
+      for (; bishops; bishops &= bishops - 1)
+        sliderQueries.push_back({chess::magic::Slider::Bishop,
+                                 static_cast<chess::Square>(chess::bb::ctz64(bishops)), occ});
+    }
+  }
+  const chess::magic::Backend originalBackend = chess::magic::backend();
+  auto sliderPass = [&]
+  {
+    chess::bb::Bitboard acc = 0;
+    for (const SliderQuery &q : sliderQueries)
+      acc ^= chess::magic::sliding_attacks(q.s, q.sq, q.occ ^ acc);
+    keep(acc);
+    return sliderQueries.size();
+  };
+  // The xor with acc chains the lookups, so the numbers are latency, as in movegen/eval.
+  benches.push_back({"sliding_attacks/magic", sliderPass,
+                     [] { chess::magic::set_backend(chess::magic::Backend::Magic); }});
+  if (chess::magic::pext_available())
+    benches.push_back({"sliding_attacks/pext", sliderPass,
+                       [] { chess::magic::set_backend(chess::magic::Backend::Pext); }});
+
+  // ---- transposition table ----
+  engine::TT tt(16);
+  std::vector<std::uint64_t> ttKeys;
+  for (std::size_t i = 0; i < corpus.positions.size(); ++i)
+  {
+    chess::Position p = corpus.positions[i];
+    ttKeys.push_back(p.hash());
+    for (const chess::Move &m : corpus.legal[i])
+    {
+      chess::StateInfo st{};
+      p.doLegalMove(m, st);
+      ttKeys.push_back(p.hash());
+      p.undoMove();
+    }
+  }
+  std::vector<std::uint64_t> missKeys(ttKeys.size());
+  for (auto &k : missKeys)
+    k = rng.next();
+
+  auto ttFill = [&]
+  {
+    tt.clear();
+    for (std::size_t i = 0; i < ttKeys.size(); ++i)
+      tt.store(ttKeys[i], static_cast<int32_t>(i & 1023), static_cast<int16_t>(i & 15),
+               engine::Bound::Exact, chess::Move{});
+  };
+  benches.push_back({"tt/store", [&]
+                     {
+                       for (std::size_t i = 0; i < ttKeys.size(); ++i)
+                         tt.store(ttKeys[i], static_cast<int32_t>(i & 1023), static_cast<int16_t>(i & 15),
+                                  engine::Bound::Lower, chess::Move{});
+                       return ttKeys.size();
+                     },
+                     [&] { tt.clear(); }});
+  benches.push_back({"tt/probe_into-hit", [&]
+                     {
+                       engine::TTEntry e{};
+                       int hits = 0;
+                       for (std::uint64_t k : ttKeys)
+                         hits += tt.probe_into(k, e);
+                       keep(hits);
+                       return ttKeys.size();
+                     },
+                     ttFill});
+  benches.push_back({"tt/probe_into-miss", [&]
+                     {
+                       engine::TTEntry e{};
+                       int hits = 0;
+                       for (std::uint64_t k : missKeys)
+                         hits += tt.probe_into(k, e);
+                       keep(hits);
+                       return missKeys.size();
+                     },
+                     ttFill});
+
+  // ---- make / unmake ----
+  std::vector<chess::Position> scratch = corpus.positions;
+  benches.push_back({"position/doMove+undoMove", [&]
+                     {
+                       std::uint64_t ops = 0;
+                       chess::StateInfo st{};
+                       for (std::size_t i = 0; i < scratch.size(); ++i)
+                         for (const chess::Move &m : corpus.legal[i])
+                         {
+                           keep(scratch[i].doMove(m, st));
+                           scratch[i].undoMove();
+                           ++ops;
+                         }
+                       return ops;
+                     }});
+  benches.push_back({"position/doLegalMove+undo", [&]
+                     {
+                       std::uint64_t ops = 0;
+                       chess::StateInfo st{};
+                       for (std::size_t i = 0; i < scratch.size(); ++i)
+                         for (const chess::Move &m : corpus.legal[i])
+                         {
+                           scratch[i].doLegalMove(m, st);
+                           scratch[i].undoMove();
+                           ++ops;
+                         }
+                       return ops;
+                     }});
+  // SearchPosition adds the incremental EvalAcc delta on top of the Position make.
+  benches.push_back({"searchpos/doMove+undoMove", [&]
+                     {
+                       std::uint64_t ops = 0;
+                       for (std::size_t i = 0; i < corpus.searchPositions.size(); ++i)
+                       {
+                         engine::SearchPosition &sp = *corpus.searchPositions[i];
+                         for (const chess::Move &m : corpus.legal[i])
+                         {
+                           if (sp.doMove(m))
+                             sp.undoMove();
+                           ++ops;
+                         }
+                       }
+                       return ops;
+                     }});
+  benches.push_back({"searchpos/doLegalMove+undo", [&]
+                     {
+                       std::uint64_t ops = 0;
+                       for (std::size_t i = 0; i < corpus.searchPositions.size(); ++i)
+                       {
+                         engine::SearchPosition &sp = *corpus.searchPositions[i];
+                         for (const chess::Move &m : corpus.legal[i])
+                         {
+                           if (sp.doLegalMove(m))
+                             sp.undoMove();
+                           ++ops;
+                         }
+                       }
+                       return ops;
+                     }});
+
+  // ---- move ordering sort ----
+  std::vector<std::vector<int>> sortScores;
+  for (const auto &moves : corpus.legal)
+  {
+    auto &s = sortScores.emplace_back(moves.size());
+    for (int &v : s)
+      v = static_cast<int>(rng.next() % 200'001) - 100'000;
+  }
+  benches.push_back({"sort_by_score_desc", [&]
+                     {
+                       std::array<int, chess::MAX_MOVES> sc{};
+                       std::array<chess::Move, chess::MAX_MOVES> mv{};
+                       for (std::size_t i = 0; i < corpus.legal.size(); ++i)
+                       {
+                         const int n = static_cast<int>(corpus.legal[i].size());
+                         std::copy_n(sortScores[i].begin(), n, sc.begin());
+                         std::copy_n(corpus.legal[i].begin(), n, mv.begin());
+                         engine::sort_by_score_desc(sc.data(), mv.data(), n);
+                         keep(mv[0]);
+                       }
+                       return corpus.legal.size(); // per list (unsorted copy-in included)
+                     }});
+
+  // ---- move ordering history kernel ----
+  // Random tables of the Search shapes; +2 entries of slack for the 32-bit gathers.
+  constexpr int PT = chess::PIECE_TYPE_NB, SQ = chess::SQ_NB;
+  std::vector<std::int16_t> histTables(SQ * SQ + 4 * PT * SQ + PT * SQ * PT + 2);
+  for (std::int16_t &v : histTables)
+    v = static_cast<std::int16_t>(static_cast<int>(rng.next() % 32'001) - 16'000);
+  engine::OrderHistory orderHist;
+  orderHist.fromTo = histTables.data();
+  orderHist.pieceTo = orderHist.fromTo + SQ * SQ;
+  for (int l = 0; l < 3; ++l)
+    orderHist.cont[l] = orderHist.pieceTo + (l + 1) * PT * SQ;
+  orderHist.capture = orderHist.pieceTo + 4 * PT * SQ;
+  orderHist.pieceToShift = 1;
+  benches.push_back({"history_scores", [&]
+                     {
+                       std::array<int, chess::MAX_MOVES> out{};
+                       std::uint64_t ops = 0;
+                       for (std::size_t i = 0; i < corpus.legal.size(); ++i)
+                       {
+                         const int n = static_cast<int>(corpus.legal[i].size());
+                         engine::history_scores(orderHist, corpus.positions[i].getBoard(),
+                                                corpus.legal[i].data(), n, out.data());
+                         keep(out[0]);
+                         ops += n;
+                       }
+                       return ops; // per move
+                     }});
+
+  // ---- move generation, per mode ----
+  std::array<chess::Move, chess::MAX_MOVES> genOut{};
+  auto genBench = [&](const char *name, auto gen, bool checksOnly)
+  {
+    benches.push_back({name, [&, gen, checksOnly]
+                       {
+                         int acc = 0;
+                         std::uint64_t calls = 0;
+                         auto one = [&](const chess::Position &p)
+                         {
+                           chess::MoveBuffer buf(genOut.data(), chess::MAX_MOVES);
+                           acc += gen(p, buf);
+                           ++calls;
+                         };
+                         if (checksOnly)
+                           for (std::size_t i : corpus.inCheck)
+                             one(corpus.positions[i]);
+                         else
+                           for (const chess::Position &p : corpus.positions)
+                             one(p);
+                         keep(acc);
+                         return calls;
+                       }});
+  };
+  genBench("movegen/legal", [&](const chess::Position &p, chess::MoveBuffer &buf)
+           { return mg.generateLegalMoves(p.getBoard(), p.getState(), buf); }, false);
+  genBench("movegen/tactical", [&](const chess::Position &p, chess::MoveBuffer &buf)
+           { return mg.generateTacticalMoves(p.getBoard(), p.getState(), buf); }, false);
+  genBench("movegen/quiet-promotions", [&](const chess::Position &p, chess::MoveBuffer &buf)
+           { return mg.generateNonCapturePromotions(p.getBoard(), p.getState(), buf); }, false);
+  genBench("movegen/evasions", [&](const chess::Position &p, chess::MoveBuffer &buf)
+           { return mg.generateEvasions(p.getBoard(), p.getState(), buf); }, true);
+
+  if (opt.list)
+  {
+    for (const Benchmark &b : benches)
+      std::cout << b.name << "\n";
+    return 0;
+  }
+
+  std::cout << "corpus: " << corpus.positions.size() << " positions (" << corpus.inCheck.size()
+            << " in check), " << sliderQueries.size() << " slider queries, " << seeCases.size()
+            << " captures, " << ttKeys.size() << " tt keys\n";
+  std::cout << std::left << std::setw(28) << "benchmark" << std::right << std::setw(14) << "ops"
+            << std::setw(12) << "ns/op" << std::setw(12) << "cycles/op" << "\n";
+  for (const Benchmark &b : benches)
+    if (selected(opt, b.name))
+      run(opt, b);
+
+  chess::magic::set_backend(originalBackend);
+  return 0;
+}
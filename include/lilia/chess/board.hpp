@@ -51,6 +51,9 @@ namespace lilia::chess
       return m_piece_on[static_cast<int>(sq)];
     }
 
+    // All SQ_NB packed squares, for batched lookups.
+    LILIA_ALWAYS_INLINE const std::uint8_t *packedSquares() const noexcept { return m_piece_on.data(); }
+
     LILIA_ALWAYS_INLINE bool isEmpty(Square sq) const noexcept
     {
       return m_piece_on[static_cast<int>(sq)] == 0;
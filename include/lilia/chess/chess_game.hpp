@@ -25,7 +25,7 @@ namespace lilia::chess
     Piece getPiece(Square sq) const;
     const GameState &getGameState() const;
 
-    // Generates pseudo-legal moves and filters them by make/unmake legality.
+    // Legal moves of the current position, straight from the generator.
     const std::vector<Move> &generateLegalMoves();
     std::optional<Move> getMove(Square from, Square to);
 
@@ -46,7 +46,6 @@ namespace lilia::chess
     Position m_position;
     GameResult m_result = GameResult::Ongoing;
 
-    std::vector<Move> m_pseudo_moves;
     std::vector<Move> m_legal_moves;
 
     // Stable ownership for committed position states.
@@ -1,7 +1,6 @@
 #pragma once
 #include <array>
 #include <cstdint>
-#include <vector>
 
 #include "bitboard.hpp"
 
@@ -20,16 +19,44 @@ namespace lilia::chess::magic
     std::uint8_t shift = 0;
   };
 
+  // Index scheme used by sliding_attacks(). Pext needs BMI2 both at build time
+  // (LILIA_NATIVE on a BMI2 host) and at run time.
+  enum class Backend
+  {
+    Magic,
+    Pext
+  };
+
   void init_magics();
 
   // including the first blocker square
   bb::Bitboard sliding_attacks(Slider s, Square sq, bb::Bitboard occ) noexcept;
 
+  // Per-lookup latency of both backends measured by the last select_fastest_backend()
+  // (0 when not measured, e.g. pext without BMI2).
+  struct BackendTiming
+  {
+    double magicNs = 0.0;
+    double pextNs = 0.0;
+  };
+
+  bool pext_available() noexcept;
+  Backend backend() noexcept;
+  const char *backend_name(Backend b) noexcept;
+
+  // Both arenas are constant data, so switching only flips the lookup; apart from the
+  // calibration, the unused arena is never paged in. Call while idle. Returns false and keeps the current backend if b
+  // is unavailable.
+  bool set_backend(Backend b) noexcept;
+
+  // Short calibrated run of both lookups, then set_backend() with the faster one (PEXT is
+  // microcoded on some CPUs, e.g. AMD Zen 1/2). init_magics() does this once.
+  Backend select_fastest_backend();
+  BackendTiming last_backend_timing() noexcept;
+
   const std::array<bb::Bitboard, 64> &rook_masks();
   const std::array<bb::Bitboard, 64> &bishop_masks();
   const std::array<Magic, 64> &rook_magics();
   const std::array<Magic, 64> &bishop_magics();
-  const std::array<std::vector<bb::Bitboard>, 64> &rook_tables();
-  const std::array<std::vector<bb::Bitboard>, 64> &bishop_tables();
 
 }
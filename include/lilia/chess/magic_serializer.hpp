@@ -1,9 +1,19 @@
 #pragma once
+#include <array>
+#include <cstddef>
 #include <string>
 
-namespace lilia::chess
+#include "lilia/chess/core/magic.hpp"
+
+namespace lilia::chess::magic
 {
 
-  void serialize_magics_to_header(const std::string &outPath);
+  // Writes generated/magic_constants.hpp for the given magics: per-square entries plus the
+  // shared attack and PEXT arenas. Returns the arena length (0 on I/O failure).
+  std::size_t serialize_magics_to_header(const std::string &outPath,
+                                         const std::array<Magic, SQ_NB> &rook,
+                                         const std::array<Magic, SQ_NB> &bishop,
+                                         const std::array<bb::Bitboard, SQ_NB> &rookMask,
+                                         const std::array<bb::Bitboard, SQ_NB> &bishopMask);
 
 }
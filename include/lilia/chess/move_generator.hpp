@@ -11,19 +11,22 @@ namespace lilia::chess
 
   struct Move;
 
-  // Generates pseudo-legal moves for a position, including specialized subsets for search.
+  // Generates strictly legal moves: checkers, pins and the check-block mask are computed up
+  // front, so every emitted move may be played with Position::doLegalMove.
   class MoveGenerator
   {
   public:
-    // Full pseudo-legal move generation (quiet moves + captures + promotions + en passant +
-    // optionally castling)
+    // All legal moves (quiet moves + captures + promotions + en passant + castling)
+    void generateLegalMoves(const Board &b, const GameState &st, std::vector<Move> &out) const;
+
+    // Historical name, same legal set as generateLegalMoves().
     void generatePseudoLegalMoves(const Board &b, const GameState &st, std::vector<Move> &out) const;
 
-    // Captures + promotions (including en passant and quiet promotions)
+    // Captures + promotions (including en passant and quiet promotions); evasions when in check
     void generateTacticalMoves(const Board &b, const GameState &st, std::vector<Move> &out) const;
 
     // Check evasions: safe king moves plus (in single-check) capturing the checker and/or blocking
-    // the check Pseudo-legal — final legality is verified via doMove()
+    // the check
     void generateEvasions(const Board &b, const GameState &st, std::vector<Move> &out) const;
 
     // Non-capture promotions only (i.e., quiet promotions)
@@ -31,8 +34,12 @@ namespace lilia::chess
                                       std::vector<Move> &out) const;
 
     // Return: num generated moves
+    int generateLegalMoves(const Board &, const GameState &, MoveBuffer &buf);
     int generatePseudoLegalMoves(const Board &, const GameState &, MoveBuffer &buf);
     int generateTacticalMoves(const Board &, const GameState &, MoveBuffer &buf);
+    // Non-captures without promotions (castling included). Together with the tactical moves
+    // this is the full legal set; returns 0 when in check (use generateEvasions).
+    int generateQuietMoves(const Board &, const GameState &, MoveBuffer &buf);
     int generateEvasions(const Board &, const GameState &, MoveBuffer &buf);
     int generateNonCapturePromotions(const Board &b, const GameState &st, MoveBuffer &buf);
   };
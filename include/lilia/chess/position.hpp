@@ -83,6 +83,9 @@ namespace lilia::chess
 
     // Stockfish-style API: caller provides the next state node.
     bool doMove(const Move &m, StateInfo &newState);
+    // Trusted make for moves straight from MoveGenerator (already legal): skips the
+    // pseudo-legality test and the post-make king-safety probe.
+    void doLegalMove(const Move &m, StateInfo &newState);
     void undoMove();
 
     bool doNullMove(StateInfo &newState);
@@ -100,6 +103,7 @@ namespace lilia::chess
     StateInfo m_rootState{};
     StateInfo *m_st = &m_rootState;
 
+    void makeMove(const Move &m, const Piece &moved, StateInfo &st);
     void applyMove(const Move &m, StateInfo &st);
     void unapplyMove(const StateInfo &st);
 
@@ -30,6 +30,9 @@ namespace lilia::chess
       return v;
     }
 
+    // Seed of the key stream below; persisted data keyed by these hashes (TT files) records it.
+    inline constexpr std::uint64_t ZOBRIST_SEED = 0xC0FFEE123456789ULL;
+
     // Compile-time container for all precomputed Zobrist hash tables.
     struct Tables
     {
@@ -43,7 +46,7 @@ namespace lilia::chess
     consteval Tables generate()
     {
       Tables t{};
-      std::uint64_t seed = 0xC0FFEE123456789ULL;
+      std::uint64_t seed = ZOBRIST_SEED;
 
       for (int c = 0; c < 2; ++c)
         for (int p = 0; p < PIECE_TYPE_NB; ++p)
@@ -74,6 +77,7 @@ namespace lilia::chess
     using Tables = detail::Tables;
 
     static inline constexpr Tables tables = detail::generate();
+    static constexpr std::uint64_t seed = detail::ZOBRIST_SEED;
 
     // Convenience refs (remain constant expressions).
     static constexpr auto &piece = tables.piece;
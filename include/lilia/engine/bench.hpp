@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+
+#include "config.hpp"
+
+namespace lilia::engine
+{
+
+  struct BenchOptions
+  {
+    int depth = 8;
+    int threads = 1;
+    std::size_t hashMb = 16;
+    // Speed only: the node signature does not depend on the pawn hash.
+    std::size_t pawnHashMb = EngineConfig{}.pawnHashMb;
+    bool sharedPawnHash = EngineConfig{}.sharedPawnHash;
+  };
+
+  struct BenchResult
+  {
+    std::uint64_t nodes = 0; // signature: changes iff search behaviour changes (threads == 1)
+    std::uint64_t elapsedMs = 0;
+  };
+
+  // Fixed-depth search over the embedded positions with a fresh TT and fresh heuristics,
+  // printing per-position nodes/time and the totals. Single-threaded runs are
+  // deterministic, so the node total identifies functional changes between builds.
+  BenchResult run_bench(std::ostream &os, const BenchOptions &opt = {});
+
+  std::span<const char *const> bench_positions();
+
+}
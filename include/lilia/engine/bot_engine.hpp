@@ -9,6 +9,7 @@
 #include "lilia/chess/move.hpp"
 #include "engine.hpp"
 #include "search.hpp"
+#include "time_manager.hpp"
 
 namespace lilia::chess
 {
@@ -32,10 +33,19 @@ namespace lilia::engine
     explicit BotEngine(const EngineConfig &cfg = {});
     ~BotEngine();
 
+    // thinkMillis > 0 is a fixed move time, <= 0 searches until maxDepth or cancel.
     SearchResult findBestMove(chess::ChessGame &gameState, int maxDepth, int thinkMillis,
                               std::atomic<bool> *externalCancel = nullptr);
+    SearchResult findBestMove(chess::ChessGame &gameState, int maxDepth, const TimeLimits &limits,
+                              std::atomic<bool> *externalCancel = nullptr);
     const engine::SearchStats &getLastSearchStats() const;
 
+    void setConfig(const EngineConfig &cfg);
+    void newGame();
+
+    Engine &engine() noexcept { return m_engine; }
+    const Engine &engine() const noexcept { return m_engine; }
+
   private:
     Engine m_engine;
   };
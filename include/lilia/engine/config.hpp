@@ -1,19 +1,35 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <string>
 
 namespace lilia::engine
 {
+  // How the transposition table asks the OS for memory.
+  enum class TTPagePolicy : std::uint8_t
+  {
+    Off,    // plain allocation
+    Auto,   // 2 MB aligned + madvise(MADV_HUGEPAGE) where available
+    HugeTLB // reserved MAP_HUGETLB pages (1 GB, then 2 MB), falls back to Auto
+  };
+
   struct EngineConfig
   {
     int maxDepth = 12; // slightly deeper; iterative deepening helps stability
     std::uint64_t maxNodes = 100000;
     std::size_t ttSizeMb = 1024; // larger TT eases aspiration/transpositions
+    TTPagePolicy ttPages = TTPagePolicy::Auto;
+    std::string ttSharedName;    // non-empty => TT lives in this POSIX shm segment, shared by processes
+    std::size_t pawnHashMb = 2;  // per table
+    bool sharedPawnHash = true;  // one pawn hash for all search threads
+    bool useEvalHash = true;     // cache full evaluations per search thread
+    std::size_t evalHashMb = 4;  // per thread
     bool useNullMove = true;     // good for middlegame; quiescence fixes reduce risks
     bool useLMR = true;          // mild reductions
     bool useAspiration = true;   // stable with score normalization
     int aspirationWindow = 20;   // not too tight, otherwise re-search flapping
     int threads = 0;             // 0 => auto (HW); engine limits anyway
+    bool pinThreads = false;     // pin pool workers to cores (dedicated machines only)
     bool useLMP = true;          // Late Move Pruning (quiet moves, shallow)
     bool useIID = true;          // Internal Iterative Deepening for uncertain nodes
     bool useSingularExt = true;  // extended search on best moves
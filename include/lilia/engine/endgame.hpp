@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+#include "lilia/chess/board.hpp"
+
+namespace lilia::engine::endgame
+{
+
+  // Material configurations with an evaluation of their own; the material table picks one
+  // per configuration and the generic terms are skipped.
+  enum class EvalFn : std::uint8_t
+  {
+    None,
+    Draw, // KR vs KR
+    KPK,  // exact, from the bitbase
+    KBNK  // drive the bare king into a corner of the bishop's colour
+  };
+
+  // Configurations with a scale factor of their own for the EG part. NO_SCALE means the
+  // position is not one the function knows, and the generic endgame scaling decides.
+  enum class ScaleFn : std::uint8_t
+  {
+    None,
+    KRPKR, // defending king in front of the pawn
+    KBPsK, // wrong bishop, rook pawns on one file: fortress in the corner
+    KBPKB  // opposite bishops, pawn blockaded by king or bishop
+  };
+
+  constexpr int NO_SCALE = -1;
+
+  // Builds the KPK bitbase (a few ms) on the first call; every Evaluator makes sure of it.
+  void init();
+
+  // Win for the pawn's side with correct play. The side with the pawn is the one whose
+  // pawn bitboard is non-empty; b must be a KPK position.
+  bool kpk_win(const chess::Board &b, chess::Color stm) noexcept;
+
+  // base is the material + PST score of the position (white's view), the result too.
+  int evaluate(EvalFn f, const chess::Board &b, chess::Color stm, int base) noexcept;
+
+  int scale(ScaleFn f, const chess::Board &b) noexcept;
+
+}
@@ -1,18 +1,24 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <string>
 
 #include "lilia/chess/core/magic.hpp"
 #include "lilia/chess/move.hpp"
 #include "lilia/chess/position.hpp"
 #include "config.hpp"
+#include "endgame.hpp"
+#include "transposition_table.hpp"
 
 namespace lilia::engine
 {
   struct SearchStats;
+  struct SearchInfo;
+  class TimeManager;
 
   class Engine
   {
@@ -24,13 +30,31 @@ namespace lilia::engine
     {
       static std::once_flag magic_once;
       std::call_once(magic_once, []()
-                     { chess::magic::init_magics(); });
+                     {
+                       chess::magic::init_magics();
+                       endgame::init();
+                     });
     }
+    // tm (optional) bounds the search by time; cancel is polled with the node ticks.
     std::optional<chess::Move> find_best_move(chess::Position &pos, int maxDepth = 8,
-                                              std::shared_ptr<std::atomic<bool>> stop = nullptr);
+                                              std::shared_ptr<std::atomic<bool>> stop = nullptr,
+                                              TimeManager *tm = nullptr,
+                                              const std::atomic<bool> *cancel = nullptr);
     const SearchStats &getLastSearchStats() const;
     const EngineConfig &getConfig() const;
 
+    // Apply new options in place; the TT is only reallocated when ttSizeMb/ttPages/ttSharedName change.
+    void setConfig(const EngineConfig &cfg);
+    // Forget everything learned so far (TT, history tables, eval caches).
+    void newGame();
+    // Page backing the TT actually received (see EngineConfig::ttPages).
+    TTPageMode ttPageMode() const;
+    // Per-iteration progress of the main search (see Search::set_info_callback).
+    void setInfoCallback(std::function<void(const SearchInfo &)> cb);
+    // TT persistence for warm starts; loading adopts the file's table size (cfg.ttSizeMb).
+    bool saveHash(const std::string &path) const;
+    bool loadHash(const std::string &path);
+
   private:
     struct Impl;
     Impl *pimpl;
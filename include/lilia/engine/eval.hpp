@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 namespace lilia::engine
@@ -10,11 +11,37 @@ namespace lilia::engine
     Evaluator() noexcept;
     ~Evaluator() noexcept;
 
-    // evaluation in cp in the view of white
+    // evaluation in cp in the view of white; NNUE when the position carries an accumulator
     int evaluate(const SearchPosition &pos) const;
 
-    // Eval- & Pawn-Caches clearing
+    // Same score, but may stop after the cheap terms (material, PST, pawn structure) once
+    // they are far enough outside [alpha, beta] (white's view) that the rest cannot bring
+    // the score back in. exact is false for such an early estimate, which then only says
+    // on which side of the window the score lies.
+    int evaluate(const SearchPosition &pos, int alpha, int beta, bool &exact) const;
+
+    // Eval- & Pawn-Caches clearing; a shared pawn table is left to its owner.
     void clearCaches() const noexcept;
+    // Pawn hash only, in O(1) (the old entries just stop verifying).
+    void clearPawnHash() const noexcept;
+
+    // Pawn hash: private to this Evaluator unless sharePawnHash() points it at owner's
+    // table (lazy SMP helpers). setPawnHashSize() goes back to a private table if shared;
+    // the current size keeps the contents. Both only while no search is running.
+    void setPawnHashSize(std::size_t mb);
+    void sharePawnHash(const Evaluator &owner);
+
+    // Full-eval hash (zobrist key -> final score), private to this Evaluator and so to
+    // its search thread. 0 MB turns it off; the current size keeps the contents.
+    void setEvalHashSize(std::size_t mb);
+
+    struct EvalHashStats
+    {
+      std::uint64_t probes = 0;
+      std::uint64_t hits = 0;
+    };
+    EvalHashStats evalHashStats() const noexcept;
+    void resetEvalHashStats() const noexcept;
 
     Evaluator(const Evaluator &) = delete;
     Evaluator &operator=(const Evaluator &) = delete;
@@ -22,6 +49,8 @@ namespace lilia::engine
     Evaluator &operator=(Evaluator &&) = delete;
 
   private:
+    int evaluateUncached(const SearchPosition &pos, int alpha, int beta, bool &exact) const;
+
     struct Impl;
     mutable Impl *m_impl = nullptr;
   };
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 
 #include "eval_shared.hpp"
 #include "eval_alias.hpp"
@@ -54,15 +55,24 @@ namespace lilia::engine
     }
   }
 
+  // Material key: one 4-bit count per (color, non-king piece type), so the key is exact
+  // and moves with the counts in add_piece/remove_piece.
+  LILIA_ALWAYS_INLINE std::uint64_t mat_key_unit(int side, int pt)
+  {
+    return pt < 5 ? (std::uint64_t{1} << (4 * (side * 5 + pt))) : 0;
+  }
+
   struct EvalAcc
   {
     int mg = 0, eg = 0, phase = 0;
     int P[2]{}, N[2]{}, B[2]{}, R[2]{}, Q[2]{};
     int kingSq[2]{-1, -1};
+    std::uint64_t matKey = 0;
 
     void clear()
     {
       mg = eg = phase = 0;
+      matKey = 0;
       for (int i = 0; i < 2; ++i)
         P[i] = N[i] = B[i] = R[i] = Q[i] = 0, kingSq[i] = -1;
     }
@@ -101,6 +111,7 @@ namespace lilia::engine
         mg += VAL_MG[pt] + pst_mg(PType, s);
         eg += VAL_EG[pt] + pst_eg(PType, s);
         phase += PHASE_W[pt];
+        matKey += mat_key_unit(0, pt);
         switch (PType)
         {
         case chess::PieceType::Pawn:
@@ -134,6 +145,7 @@ namespace lilia::engine
         mg -= VAL_MG[pt] + pst_mg(PType, mirror_sq_black(s));
         eg -= VAL_EG[pt] + pst_eg(PType, mirror_sq_black(s));
         phase += PHASE_W[pt];
+        matKey += mat_key_unit(1, pt);
         switch (PType)
         {
         case chess::PieceType::Pawn:
@@ -176,6 +188,7 @@ namespace lilia::engine
       eg -= VAL_EG[i] + pst_eg(pt, mirror_sq_black(sq));
     }
     phase += PHASE_W[i];
+    matKey += mat_key_unit(s, i);
 
     switch (pt)
     {
@@ -217,6 +230,7 @@ namespace lilia::engine
       eg += VAL_EG[i] + pst_eg(pt, mirror_sq_black(sq));
     }
     phase -= PHASE_W[i];
+    matKey -= mat_key_unit(s, i);
 
     switch (pt)
     {
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
+
 #include "config.hpp"
+#include "lilia/chess/board.hpp"
 #include "lilia/chess/move.hpp"
 #include "lilia/chess/position.hpp"
 #include "lilia/chess/compiler.hpp"
@@ -67,4 +70,22 @@ namespace lilia::engine
     return score;
   }
 
+  // History tables read by history_scores(), flattened. The AVX2 path gathers 32 bits per
+  // entry, so every table must be followed by one more int16 in memory (Search keeps its
+  // tables in a PaddedHistory).
+  struct OrderHistory
+  {
+    const std::int16_t *fromTo = nullptr;  // [from][to]
+    const std::int16_t *pieceTo = nullptr; // [mover][to]
+    const std::int16_t *cont[3] = {};      // [mover][to] slices 1..3 plies back, nullptr = none
+    const std::int16_t *capture = nullptr; // [mover][to][victim]
+    int pieceToShift = 0;
+  };
+
+  // History part of the ordering score for a batch of moves: capture history for captures,
+  // fromTo + (pieceTo >> shift) + cont[0] + (cont[1] >> 1) + (cont[2] >> 1) for the rest.
+  // Uses AVX2 gathers when built with it (LILIA_NATIVE on an AVX2 host), scalar otherwise.
+  void history_scores(const OrderHistory &h, const chess::Board &b, const chess::Move *moves,
+                      int n, int *out) noexcept;
+
 }
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "lilia/chess/board.hpp"
+#include "lilia/chess/game_state.hpp"
+#include "lilia/chess/compiler.hpp"
+
+namespace lilia::engine::nnue
+{
+
+  // HalfKP 2x256 -> 32 -> 32 -> 1. Inputs per perspective: (own king square, non-king
+  // piece relative to the perspective, square), squares flipped for black.
+  constexpr int INPUTS = chess::SQ_NB * 10 * chess::SQ_NB;
+  constexpr int L1 = 256; // accumulator width per perspective
+  constexpr int L2 = 32;
+  constexpr int L3 = 32;
+
+  struct alignas(64) Accumulator
+  {
+    std::int16_t v[2][L1]; // [perspective]
+  };
+
+  // Reads a net file (layout in nnue.cpp). On failure the current net is kept and err
+  // says why. Not thread-safe: only while no search is running.
+  bool load(const std::string &path, std::string &err);
+  void unload() noexcept;
+  bool loaded() noexcept;
+  const std::string &loaded_path() noexcept;
+  // Changes with every load() and unload(); caches of NNUE scores key on it.
+  std::uint32_t generation() noexcept;
+
+  // Handcrafted vs NNUE; NNUE needs a loaded net. Picked up by positions built afterwards,
+  // i.e. from the next search on.
+  void set_enabled(bool on) noexcept;
+  bool enabled() noexcept;
+  bool active() noexcept;
+
+  void refresh(Accumulator &acc, const chess::Board &b) noexcept;
+
+  // acc = prev with the move recorded in st applied; b is the board after the move.
+  void update(Accumulator &acc, const Accumulator &prev, const chess::StateInfo &st,
+              const chess::Board &b) noexcept;
+
+  // Centipawns from the side to move's view.
+  int evaluate(const Accumulator &acc, chess::Color stm) noexcept;
+
+}
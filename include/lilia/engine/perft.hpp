@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <vector>
+
+#include "lilia/chess/move.hpp"
+#include "lilia/chess/position.hpp"
+
+namespace lilia::engine
+{
+
+  struct PerftOptions
+  {
+    int threads = 1;         // root moves are split over the ThreadPool when > 1
+    std::size_t hashMb = 0;  // 0 = no perft hash
+    bool bulk = true;        // count depth-1 leaves from the generator instead of making them
+    const std::atomic<bool> *stop = nullptr; // polled at interior nodes; counts are partial once set
+  };
+
+  struct PerftDivide
+  {
+    chess::Move move{};
+    std::uint64_t nodes = 0;
+  };
+
+  struct PerftResult
+  {
+    std::uint64_t nodes = 0;
+    std::uint64_t elapsedMs = 0;
+    std::vector<PerftDivide> divide; // one entry per root move, generator order
+    bool stopped = false;            // opt.stop was raised before the count finished
+  };
+
+  // Leaf count of the legal move tree below pos. Exercises MoveGenerator and
+  // Position::doLegalMove/undoMove only, so it doubles as a movegen regression check.
+  PerftResult perft(const chess::Position &pos, int depth, const PerftOptions &opt = {});
+
+  struct PerftCase
+  {
+    const char *name;
+    const char *fen;
+    int depth;                            // default suite depth
+    std::array<std::uint64_t, 7> counts;  // published counts by depth, [0] unused
+  };
+
+  // Standard positions (start, Kiwipete, CPW 3..6) with published counts.
+  std::span<const PerftCase> perft_suite();
+
+  // Runs the suite (each case at min(depth, maxDepth) if maxDepth > 0), prints one line per
+  // position plus total nodes and nps. Returns false on any count mismatch or when stopped.
+  bool run_perft_suite(std::ostream &os, const PerftOptions &opt, int maxDepth = 0);
+
+}
@@ -2,10 +2,13 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -13,19 +16,79 @@
 #include "lilia/engine/search_position.hpp"
 #include "lilia/chess/chess_types.hpp"
 #include "transposition_table.hpp"
+#include "time_manager.hpp"
 #include "config.hpp"
 #include "eval.hpp"
 #include "lilia/chess/compiler.hpp"
 
 namespace lilia::engine
 {
-  static constexpr int CONTHIST_LAYERS = 6; // 1..6 ply
+  static constexpr int CONTHIST_LAYERS = 3; // 1..3 ply
+
+  // Continuation history of one earlier move (piece, to): layer L is indexed by [mover][to]
+  // of the move played L+1 plies later. A node reads one layer from each of the blocks of
+  // the last three moves, so each block is a single 2.3 KB span.
+  struct ContHistBlock
+  {
+    int16_t h[CONTHIST_LAYERS][chess::PIECE_TYPE_NB][chess::SQ_NB];
+  };
+  static_assert(sizeof(ContHistBlock) == sizeof(int16_t) * CONTHIST_LAYERS * chess::PIECE_TYPE_NB * chess::SQ_NB,
+                "history_scores() reads across the layers of a block");
+
+  // A history table followed by one spare int16. The AVX2 history_scores() gathers 32 bits
+  // per int16 entry, so the gather for the last entry also reads tail. Indexes like Table.
+  template <class Table>
+  struct PaddedHistory
+  {
+    Table v{};
+    int16_t tail = 0;
+
+    LILIA_ALWAYS_INLINE auto &operator[](std::size_t i) noexcept { return v[i]; }
+    LILIA_ALWAYS_INLINE const auto &operator[](std::size_t i) const noexcept { return v[i]; }
+  };
+
+  using FromToHistory = PaddedHistory<std::array<std::array<int16_t, chess::SQ_NB>, chess::SQ_NB>>;
+  using PieceToHistory = PaddedHistory<int16_t[chess::PIECE_TYPE_NB][chess::SQ_NB]>;
+  using CaptureHistory = PaddedHistory<int16_t[chess::PIECE_TYPE_NB][chess::SQ_NB][chess::PIECE_TYPE_NB]>;
+  using ContHistory = PaddedHistory<ContHistBlock[chess::PIECE_TYPE_NB][chess::SQ_NB]>;
+
+  static_assert(offsetof(FromToHistory, tail) == sizeof(FromToHistory::v) &&
+                    offsetof(PieceToHistory, tail) == sizeof(PieceToHistory::v) &&
+                    offsetof(CaptureHistory, tail) == sizeof(CaptureHistory::v) &&
+                    offsetof(ContHistory, tail) == sizeof(ContHistory::v),
+                "each history table must be directly followed by its tail");
 
   struct SearchStoppedException : public std::exception
   {
     const char *what() const noexcept override { return "Search stopped"; }
   };
 
+  // Search-health counters. Every Search (one per thread) bumps its own copy without
+  // atomics; lazy SMP sums them once the helpers are done.
+  struct SearchCounters
+  {
+    std::uint64_t nodes = 0;  // negamax entries
+    std::uint64_t qnodes = 0; // quiescence entries
+    std::uint64_t ttProbes = 0;
+    std::array<std::uint64_t, 4> ttHits{}; // indexed by Bound
+    std::uint64_t betaCutoffs = 0;
+    std::uint64_t firstMoveCutoffs = 0;
+    std::uint64_t nullTries = 0;
+    std::uint64_t nullCutoffs = 0;
+    std::uint64_t nullVerifyFails = 0;
+    std::uint64_t probCutTries = 0;
+    std::uint64_t probCutCutoffs = 0;
+    std::uint64_t lmrReduced = 0;
+    std::uint64_t lmrResearches = 0;
+    std::uint64_t aspFailHigh = 0;
+    std::uint64_t aspFailLow = 0;
+    std::uint64_t evalHashProbes = 0;
+    std::uint64_t evalHashHits = 0;
+    std::array<std::uint64_t, MAX_PLY + 1> depthNodes{}; // nodes + qnodes spent in iteration d
+
+    SearchCounters &operator+=(const SearchCounters &o) noexcept;
+  };
+
   struct SearchStats
   {
     std::uint64_t nodes = 0;
@@ -35,8 +98,38 @@ namespace lilia::engine
     std::optional<chess::Move> bestMove;
     std::vector<std::pair<chess::Move, int>> topMoves;
     std::vector<chess::Move> bestPV;
+
+    SearchCounters counters;                    // all threads
+    std::vector<SearchCounters> threadCounters; // [0] = main, then helpers
+  };
+
+  // Stop conditions polled together with the node ticks (main thread only).
+  struct StopCheck
+  {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    const std::atomic<bool> *external = nullptr;
+
+    LILIA_ALWAYS_INLINE bool expired() const noexcept
+    {
+      if (external && external->load(std::memory_order_relaxed))
+        return true;
+      return deadline != std::chrono::steady_clock::time_point::max() &&
+             std::chrono::steady_clock::now() >= deadline;
+    }
   };
 
+  // One finished iteration of the main thread's ID loop.
+  struct SearchInfo
+  {
+    int depth = 0;
+    int score = 0;
+    std::uint64_t nodes = 0; // all threads
+    std::uint64_t elapsedMs = 0;
+    int hashfull = 0;
+    std::span<const chess::Move> pv;
+  };
+  using InfoCallback = std::function<void(const SearchInfo &)>;
+
   class Search
   {
   public:
@@ -54,8 +147,12 @@ namespace lilia::engine
     int search_root_single(SearchPosition &pos, int maxDepth,
                            std::shared_ptr<std::atomic<bool>> stop, std::uint64_t maxNodes = 0);
 
+    // helpers[i] runs as thread i + 1. The set is owned by the caller and kept between
+    // searches (histories, eval caches and scratch buffers stay warm); missing helpers are
+    // created seeded from this search's heuristics, surplus ones are released.
     int search_root_lazy_smp(SearchPosition &pos, int maxDepth,
-                             std::shared_ptr<std::atomic<bool>> stop, int maxThreads,
+                             std::shared_ptr<std::atomic<bool>> stop,
+                             std::vector<std::unique_ptr<Search>> &helpers, int maxThreads,
                              std::uint64_t maxNodes = 0);
     LILIA_ALWAYS_INLINE void set_node_limit(std::shared_ptr<std::atomic<std::uint64_t>> shared, std::uint64_t limit)
     {
@@ -64,7 +161,7 @@ namespace lilia::engine
     }
 
     [[nodiscard]] LILIA_ALWAYS_INLINE const SearchStats &getStats() const noexcept { return stats; }
-    void clearSearchState(); // Killers/History reset
+    void clearSearchState(); // Killers/History/eval cache reset
 
     LILIA_ALWAYS_INLINE TT &ttRef() noexcept { return tt; }
 
@@ -72,28 +169,43 @@ namespace lilia::engine
     alignas(64) std::array<std::array<chess::Move, 2>, MAX_PLY> killers{};
 
     // Basehistory (from->to)
-    alignas(64) std::array<std::array<int16_t, chess::SQ_NB>, chess::SQ_NB> history{};
+    alignas(64) FromToHistory history{};
 
     // Quiet-History: (moverPiece, to)
-    alignas(64) int16_t quietHist[chess::PIECE_TYPE_NB][chess::SQ_NB] = {};
+    alignas(64) PieceToHistory quietHist{};
 
     // Capture-History: (moverPiece, to, capturedPiece)
-    alignas(64) int16_t captureHist[chess::PIECE_TYPE_NB][chess::SQ_NB][chess::PIECE_TYPE_NB] = {};
+    alignas(64) CaptureHistory captureHist{};
 
     alignas(64) chess::Move counterMove[chess::SQ_NB][chess::SQ_NB] = {};
     alignas(64) int16_t counterHist[chess::SQ_NB][chess::SQ_NB] = {};
-    alignas(64) int16_t contHist[CONTHIST_LAYERS][chess::PIECE_TYPE_NB][chess::SQ_NB][chess::PIECE_TYPE_NB][chess::SQ_NB];
+    // Continuation history, by (piece, to) of the earlier move.
+    alignas(64) ContHistory contHist;
+
+    // Main thread only: tm decides between iterations whether to go on, its hard deadline
+    // and externalStop are checked on node ticks. Pass nullptrs to clear.
+    void set_time_control(TimeManager *tm, const std::atomic<bool> *externalStop);
+
+    // Called by the main thread (id 0) after every completed depth; helpers never report.
+    void set_info_callback(InfoCallback cb) { onInfo_ = std::move(cb); }
 
     LILIA_ALWAYS_INLINE void set_thread_id(int id) { thread_id_ = id; }
     [[nodiscard]] LILIA_ALWAYS_INLINE int thread_id() const { return thread_id_; }
 
   private:
     int thread_id_ = 0; // 0 = main, >0 helpers
+    InfoCallback onInfo_;
+    TimeManager *tm_ = nullptr;
+    StopCheck stopCheck_;
+    const StopCheck *activeStopCheck_ = nullptr;
     int negamax(SearchPosition &pos, int depth, int alpha, int beta, int ply, chess::Move &refBest,
                 int parentStaticEval = 0, const chess::Move *excludedMove = nullptr);
-    int quiescence(SearchPosition &pos, int alpha, int beta, int ply);
-    std::vector<chess::Move> build_pv_from_tt(SearchPosition pos, int max_len = 16);
+    int quiescence(SearchPosition &pos, int alpha, int beta, int ply, int qdepth = 0);
+    // Follows TT moves from pos and undoes them again before returning.
+    std::vector<chess::Move> build_pv_from_tt(SearchPosition &pos, int max_len = 16);
     int signed_eval(SearchPosition &pos);
+    // Side-to-move window; may return a lazy estimate outside it (exact = false).
+    int signed_eval(SearchPosition &pos, int alpha, int beta, bool &exact);
     // Copy global heuristics into this worker (killers are reset, on purpose)
     void copy_heuristics_from(const Search &src);
     // Merge this worker's heuristics into the global (killers are NOT merged)
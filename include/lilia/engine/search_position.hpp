@@ -3,9 +3,11 @@
 #include <array>
 #include <cassert>
 #include <utility>
+#include <vector>
 
 #include "config.hpp"
 #include "eval_acc.hpp"
+#include "nnue.hpp"
 #include "lilia/chess/position.hpp"
 #include "lilia/engine/see.hpp"
 
@@ -19,13 +21,13 @@ namespace lilia::engine
     explicit SearchPosition(const chess::Position &pos)
         : m_pos(pos)
     {
-      m_stack[0].eval.build_from_board(m_pos.getBoard());
+      init_eval();
     }
 
     explicit SearchPosition(chess::Position &&pos)
         : m_pos(std::move(pos))
     {
-      m_stack[0].eval.build_from_board(m_pos.getBoard());
+      init_eval();
     }
 
     LILIA_ALWAYS_INLINE const chess::Position &position() const noexcept { return m_pos; }
@@ -45,9 +47,23 @@ namespace lilia::engine
     LILIA_ALWAYS_INLINE bool isPseudoLegal(const chess::Move &m) const { return m_pos.isPseudoLegal(m); }
 
     LILIA_ALWAYS_INLINE const EvalAcc &evalAcc() const noexcept { return m_stack[m_ply].eval; }
-    void rebuildEvalAcc() { m_stack[m_ply].eval.build_from_board(m_pos.getBoard()); }
+    void rebuildEvalAcc()
+    {
+      m_stack[m_ply].eval.build_from_board(m_pos.getBoard());
+      if (!m_nnue.empty())
+        nnue::refresh(m_nnue[m_ply], m_pos.getBoard());
+    }
+
+    // Null when this position was built with the handcrafted evaluation (nnue::active()
+    // is sampled once, at construction).
+    LILIA_ALWAYS_INLINE const nnue::Accumulator *nnueAcc() const noexcept
+    {
+      return m_nnue.empty() ? nullptr : &m_nnue[m_ply];
+    }
 
     bool doMove(const chess::Move &m);
+    // For generator output only (see chess::Position::doLegalMove); false only on stack overflow.
+    bool doLegalMove(const chess::Move &m);
     void undoMove();
 
     bool doNullMove();
@@ -61,12 +77,14 @@ namespace lilia::engine
     };
 
     static void applyEvalDelta(const chess::StateInfo &st, EvalAcc &eval);
+    void init_eval();
 
   private:
     static constexpr int STACK_CAP = MAX_PLY + 8;
 
     chess::Position m_pos;
     std::array<StackEntry, STACK_CAP> m_stack{};
+    std::vector<nnue::Accumulator> m_nnue; // per ply, empty with the handcrafted eval
     int m_ply = 0;
   };
 }
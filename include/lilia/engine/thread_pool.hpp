@@ -1,103 +1,201 @@
 #pragma once
-#include <condition_variable>
+#include <array>
+#include <atomic>
 #include <cstddef>
-#include <functional>
-#include <future>
+#include <cstdint>
+#include <exception>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
-#include <vector>
+#include <type_traits>
 
 namespace lilia::engine
 {
 
+  // Work-stealing pool. Every worker owns a fixed-size Chase-Lev deque; work pushed from
+  // threads outside the pool goes through a bounded lock-free injector queue. Tasks are
+  // plain {fn, ctx, range} records pointing into the submitting frame, so submission never
+  // allocates. Idle workers steal, then sleep on an epoch counter.
   class ThreadPool
   {
   public:
+    using RunFn = void (*)(void *ctx, std::size_t begin, std::size_t end);
+
+    struct Task
+    {
+      RunFn run = nullptr;
+      void *ctx = nullptr;
+      std::size_t begin = 0;
+      std::size_t end = 0;
+    };
+
+    static constexpr std::size_t MAX_WORKERS = 256;
+
     static ThreadPool &instance(int desired_threads = -1)
     {
       static ThreadPool pool(desired_threads);
       return pool;
     }
 
-    template <class F, class... Args>
-    auto submit(F &&f, Args &&...args) -> std::future<std::invoke_result_t<F, Args...>>
-    {
-      using R = std::invoke_result_t<F, Args...>;
+    ~ThreadPool();
 
-      auto task_ptr = std::make_shared<std::packaged_task<R()>>(
-          std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
 
-      std::future<R> fut = task_ptr->get_future();
+    std::size_t size() const noexcept { return count_.load(std::memory_order_acquire); }
+    void maybe_resize(int desired);
 
-      {
-        std::lock_guard<std::mutex> lk(m_);
-        q_.emplace([task_ptr]() mutable
-                   { (*task_ptr)(); });
-      }
-      cv_.notify_one();
-      return fut;
-    }
+    // Pin worker i to logical CPU (i + 1) % hw. CPU 0 is kept free of workers for the thread
+    // that drives the search, which itself stays unpinned. Off restores the process affinity
+    // mask. No-op where unsupported.
+    void set_pinning(bool on);
 
-    void maybe_resize(int desired)
+    // Runs body(i) for every i in [begin, end) and returns once all calls finished. The
+    // caller takes part: ranges are halved lazily down to `grain` and the halves are
+    // stolen by idle workers. The first exception thrown by body is rethrown here (the
+    // remaining indices are skipped).
+    template <class F>
+    void parallel_for(std::size_t begin, std::size_t end, F &&body, std::size_t grain = 1)
     {
-      if (desired <= 0)
+      if (begin >= end)
         return;
-      std::lock_guard<std::mutex> lk(m_);
-      while (!stop_ && threads_.size() < (size_t)desired)
-      {
-        threads_.emplace_back([this]
-                              { worker(); });
-      }
-    }
 
-    ~ThreadPool()
-    {
-      {
-        std::lock_guard<std::mutex> lk(m_);
-        stop_ = true;
-      }
-      cv_.notify_all();
-      for (auto &t : threads_)
-        if (t.joinable())
-          t.join();
+      using Body = std::remove_reference_t<F>;
+      Job<Body> job;
+      job.body = &body;
+      job.grain = grain ? grain : 1;
+      job.pending.store(end - begin, std::memory_order_relaxed);
+
+      run_range<Body>(&job, begin, end);
+      help_until(job.pending);
+
+      if (job.error)
+        std::rethrow_exception(job.error);
     }
 
   private:
-    explicit ThreadPool(int desired_threads)
+    struct JobBase
     {
-      int n = desired_threads > 0 ? desired_threads : (int)std::thread::hardware_concurrency();
-      if (n <= 0)
-        n = 1;
-      threads_.reserve(n);
-      for (int i = 0; i < n; ++i)
-        threads_.emplace_back([this]
-                              { worker(); });
-    }
+      std::atomic<std::size_t> pending{0};
+      std::atomic<bool> failed{false};
+      std::exception_ptr error;
+      std::size_t grain = 1;
+    };
 
-    void worker()
+    template <class Body>
+    struct Job : JobBase
     {
-      for (;;)
+      Body *body = nullptr;
+    };
+
+    template <class Body>
+    static void run_range(void *ctx, std::size_t b, std::size_t e)
+    {
+      auto *job = static_cast<Job<Body> *>(ctx);
+
+      // Lazy binary splitting: publish the right half, keep the left.
+      while (e - b > job->grain)
+      {
+        const std::size_t mid = b + (e - b) / 2;
+        if (!instance().push(Task{&run_range<Body>, ctx, mid, e}))
+          break; // queues full: just run the whole range here
+        e = mid;
+      }
+
+      if (!job->failed.load(std::memory_order_relaxed))
       {
-        std::function<void()> job;
+        try
         {
-          std::unique_lock<std::mutex> lk(m_);
-          cv_.wait(lk, [&]
-                   { return stop_ || !q_.empty(); });
-          if (stop_ && q_.empty())
-            return;
-          job = std::move(q_.front());
-          q_.pop();
+          for (std::size_t i = b; i < e; ++i)
+            (*job->body)(i);
+        }
+        catch (...)
+        {
+          if (!job->failed.exchange(true, std::memory_order_acq_rel))
+            job->error = std::current_exception();
         }
-        job();
       }
+
+      // Last touch of *job; the owner may return as soon as pending reaches zero.
+      const std::size_t n = e - b;
+      if (job->pending.fetch_sub(n, std::memory_order_acq_rel) == n)
+        instance().signal();
     }
 
-    std::mutex m_;
-    std::condition_variable cv_;
-    std::queue<std::function<void()>> q_;
-    std::vector<std::thread> threads_;
-    bool stop_ = false;
+    class Deque
+    {
+    public:
+      static constexpr std::int64_t CAP = 1 << 12;
+
+      bool push(const Task &t) noexcept;
+      bool pop(Task &out) noexcept;
+      bool steal(Task &out) noexcept;
+
+    private:
+      struct Slot
+      {
+        std::atomic<RunFn> run{nullptr};
+        std::atomic<void *> ctx{nullptr};
+        std::atomic<std::size_t> begin{0};
+        std::atomic<std::size_t> end{0};
+      };
+
+      static void store(Slot &s, const Task &t) noexcept;
+      static Task load(const Slot &s) noexcept;
+
+      alignas(64) std::atomic<std::int64_t> top_{0};
+      alignas(64) std::atomic<std::int64_t> bottom_{0};
+      alignas(64) std::array<Slot, CAP> slots_{};
+    };
+
+    // Bounded MPMC queue (Vyukov) for work coming from non-pool threads.
+    class Injector
+    {
+    public:
+      static constexpr std::size_t CAP = 1 << 10;
+
+      Injector() noexcept;
+      bool push(const Task &t) noexcept;
+      bool pop(Task &out) noexcept;
+
+    private:
+      struct Cell
+      {
+        std::atomic<std::size_t> seq{0};
+        Task task{};
+      };
+
+      alignas(64) std::atomic<std::size_t> head_{0};
+      alignas(64) std::atomic<std::size_t> tail_{0};
+      alignas(64) std::array<Cell, CAP> cells_{};
+    };
+
+    struct Worker
+    {
+      Deque deque;
+      std::thread thread;
+    };
+
+    explicit ThreadPool(int desired_threads);
+
+    bool push(const Task &t) noexcept;
+    bool find_task(Task &out) noexcept;
+    void signal() noexcept;
+    void help_until(const std::atomic<std::size_t> &pending) noexcept;
+    void worker_main(std::size_t index);
+    void apply_pinning(std::size_t index) noexcept;
+    void pin_thread(std::thread::native_handle_type handle, std::size_t index) noexcept;
+
+    std::array<std::unique_ptr<Worker>, MAX_WORKERS> workers_{};
+    std::atomic<std::size_t> count_{0};
+    Injector injector_;
+
+    alignas(64) std::atomic<std::uint32_t> epoch_{0};
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> pinned_{false};
+
+    std::mutex growMutex_;
   };
 
 }
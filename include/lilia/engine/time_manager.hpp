@@ -0,0 +1,52 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+#include "lilia/chess/move.hpp"
+
+namespace lilia::engine
+{
+  // Clock situation for one move, in ms from the side to move's point of view.
+  struct TimeLimits
+  {
+    int time = -1;     // remaining time, -1 = no clock
+    int inc = 0;       // increment per move
+    int movesToGo = 0; // 0 = sudden death
+    int moveTime = -1; // fixed time per move (wins over the clock)
+    int overhead = 0;  // reserved for GUI/network lag
+  };
+
+  // Soft/hard budget for one search. The hard deadline is enforced from the main
+  // thread's node ticks; the soft one is re-evaluated after each ID iteration and
+  // shrinks while the best move stays put, grows when it changes or the score drops.
+  class TimeManager
+  {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    void start(const TimeLimits &lim);
+
+    [[nodiscard]] bool active() const noexcept { return active_; }
+    [[nodiscard]] clock::time_point hard_deadline() const noexcept { return hardDeadline_; }
+    [[nodiscard]] std::int64_t soft_ms() const noexcept { return softMs_; }
+    [[nodiscard]] std::int64_t hard_ms() const noexcept { return hardMs_; }
+    [[nodiscard]] std::int64_t elapsed_ms() const noexcept;
+
+    // Feed a finished iteration; true when another one is not worth starting.
+    bool iteration_done(int depth, chess::Move best, int score) noexcept;
+
+  private:
+    bool active_ = false;
+    bool fixed_ = false; // movetime: use exactly the budget
+    clock::time_point start_{};
+    clock::time_point hardDeadline_ = clock::time_point::max();
+    std::int64_t softMs_ = 0;
+    std::int64_t hardMs_ = 0;
+
+    chess::Move lastBest_{};
+    int lastScore_ = 0;
+    int stableIters_ = 0;
+    bool haveLast_ = false;
+  };
+
+}
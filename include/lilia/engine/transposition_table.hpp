@@ -1,13 +1,17 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <optional>
+#include <string>
 
 #include "lilia/chess/move.hpp"
 #include "lilia/chess/compiler.hpp"
+#include "config.hpp"
 
 namespace lilia::engine
 {
@@ -36,37 +40,64 @@ namespace lilia::engine
     }
   };
 
+  // Page backing the table actually got (may be weaker than the requested policy).
+  enum class TTPageMode : std::uint8_t
+  {
+    Normal,
+    Transparent,
+    Huge2M,
+    Huge1G,
+    Shared // POSIX shared memory segment (EngineConfig::ttSharedName)
+  };
+
+  const char *tt_page_mode_name(TTPageMode m) noexcept;
+
   class TT
   {
   public:
-    explicit TT(std::size_t mb = 16) { resize(mb); }
-
-    void resize(std::size_t mb)
+    explicit TT(std::size_t mb = 16, TTPagePolicy pages = TTPagePolicy::Auto, const std::string &sharedName = {})
     {
-      const std::size_t bytes = std::max<std::size_t>(mb, 1) * 1024ull * 1024ull;
-      clusterCount_ = std::max<std::size_t>(1, bytes / sizeof(Cluster));
-      table_.reset(new Cluster[clusterCount_]);
-      clear();
-    }
-
-    void clear() noexcept
-    {
-      if (!table_)
-        return;
-
-      std::memset(table_.get(), 0, clusterCount_ * sizeof(Cluster));
-      generation_ = 0u;
+      resize(mb, pages, sharedName);
     }
+    ~TT();
+
+    TT(const TT &) = delete;
+    TT &operator=(const TT &) = delete;
+    TT(TT &&) = delete;
+    TT &operator=(TT &&) = delete;
+
+    // Reallocates per policy and zeroes the table on the ThreadPool workers, so
+    // first touch spreads pages over the NUMA nodes the search threads run on.
+    // With a sharedName the clusters are mapped from that shm segment instead (created
+    // zeroed if missing, never unlinked) and an existing segment's contents are kept.
+    // The segment starts with the same header as a hash file and also holds the
+    // generation; a segment with another size, layout or Zobrist seed falls back to a
+    // private table.
+    void resize(std::size_t mb, TTPagePolicy pages = TTPagePolicy::Auto, const std::string &sharedName = {});
+    void clear() noexcept;
+
+    [[nodiscard]] TTPageMode page_mode() const noexcept { return pageMode_; }
+    [[nodiscard]] bool is_shared() const noexcept { return pageMode_ == TTPageMode::Shared; }
+    // Permille of sampled slots written during the current generation (UCI hashfull).
+    [[nodiscard]] int hashfull() const noexcept;
+    [[nodiscard]] std::size_t size_mb() const noexcept { return clusterCount_ * sizeof(Cluster) / (1024 * 1024); }
+
+    // Raw dump of the cluster array behind a small header (cluster count, generation,
+    // Zobrist seed). load() adopts the file's size and rejects tables from other key sets;
+    // on failure the current table is kept (or cleared if it was already resized).
+    // A shared table is never loaded into: the other processes are using it.
+    bool save(const std::string &path) const;
+    bool load(const std::string &path, TTPagePolicy pages = TTPagePolicy::Auto);
 
     LILIA_ALWAYS_INLINE void new_generation() noexcept
     {
-      ++generation_;
+      std::atomic_ref<std::uint8_t>(*generation_).fetch_add(1, std::memory_order_relaxed);
     }
 
     LILIA_ALWAYS_INLINE void prefetch(std::uint64_t key) const noexcept
     {
       if (table_)
-        LILIA_PREFETCH_L1(&table_[index(key)]);
+        LILIA_PREFETCH_L1(table_ + index(key));
     }
 
     LILIA_ALWAYS_INLINE bool probe_into(std::uint64_t key, TTEntry &out) const noexcept
@@ -512,9 +543,15 @@ namespace lilia::engine
       return 8 * age - depth - bonus;
     }
 
+    LILIA_ALWAYS_INLINE std::uint8_t generation() const noexcept
+    {
+      return std::atomic_ref<std::uint8_t>(*generation_).load(std::memory_order_relaxed);
+    }
+
     LILIA_ALWAYS_INLINE std::uint8_t current_generation() const noexcept
     {
-      return generation_ ? generation_ : 1u;
+      const std::uint8_t g = generation();
+      return g ? g : 1u;
     }
 
     LILIA_ALWAYS_INLINE std::size_t index(std::uint64_t key) const noexcept
@@ -526,9 +563,16 @@ namespace lilia::engine
 #endif
     }
 
-    std::unique_ptr<Cluster[]> table_;
+    void release() noexcept;
+    void zero_parallel() noexcept;
+    void copy_parallel(const void *src) noexcept;
+
+    Cluster *table_ = nullptr;
     std::size_t clusterCount_ = 1;
-    std::uint8_t generation_ = 0u;
+    std::size_t allocBytes_ = 0;
+    TTPageMode pageMode_ = TTPageMode::Normal;
+    std::uint8_t ownGeneration_ = 0u;
+    std::uint8_t *generation_ = &ownGeneration_; // in the segment header when shared
   };
 
 } // namespace lilia::engine
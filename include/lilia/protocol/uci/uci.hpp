@@ -1,8 +1,16 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
 #include <string>
 
+#include "lilia/engine/bot_engine.hpp"
 #include "lilia/engine/config.hpp"
 #include "lilia/chess/chess_game.hpp"
+#include "lilia/chess/core/magic.hpp"
 
 namespace lilia::protocol::uci
 {
@@ -16,12 +24,30 @@ namespace lilia::protocol::uci
   private:
     void showOptions();
     void setOption(const std::string &line);
+    // Creates the engine on first use, otherwise pushes the current options into it.
+    engine::BotEngine &prepareEngine(const engine::EngineConfig &cfg);
+    // Hash allocation/clearing and perft run off the command loop: the job prepares the
+    // engine for the current options, then runs work (if any) on it. Anything touching the
+    // engine must wait for it first; stop/quit raise m_jobStop for work that polls it.
+    void startEngineJob(std::function<void(engine::BotEngine &)> work = {});
+    void waitEngineJob();
+    void saveOrLoadHash(bool load, std::string path);
+    // Applies Slider Attacks (Auto recalibrates) and reports the choice as an info string.
+    void applySliderAttacks();
+    void reportSliderAttacks(bool forced) const;
+    // Loads/unloads EvalFile and applies Use NNUE, then reports the active evaluation.
+    void applyEvaluation();
 
     struct Options
     {
       engine::EngineConfig cfg{};
       bool ponder = false;
       int moveOverhead = 10;
+      bool searchStats = false; // print search counters after every search
+      std::string hashFile; // default path for save_hash/load_hash
+      std::optional<chess::magic::Backend> sliderAttacks; // nullopt = Auto (calibrated at startup)
+      std::string evalFile;                               // NNUE net, empty = handcrafted only
+      bool useNnue = true;                                // use the net when one is loaded
       engine::EngineConfig toEngineConfig() const { return cfg; }
     } m_options;
 
@@ -29,6 +55,16 @@ namespace lilia::protocol::uci
     std::string m_version = "1.0";
 
     chess::ChessGame m_game;
+
+    // Long-lived engine: TT, history tables and eval caches persist across
+    // position/go pairs and are reset only by ucinewgame or a Hash change.
+    std::unique_ptr<engine::BotEngine> m_engine;
+    std::size_t m_engineHashMb = 0;
+    engine::TTPagePolicy m_enginePages = engine::TTPagePolicy::Auto;
+    std::string m_engineShared;
+    std::future<void> m_engineJob;
+    std::atomic<bool> m_jobStop{false};
+    std::atomic<bool> m_perftRunning{false}; // set from go perft until its job returns
   };
 
 }
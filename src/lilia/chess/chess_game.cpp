@@ -62,7 +62,6 @@ namespace lilia::chess
 
   ChessGame::ChessGame()
   {
-    m_pseudo_moves.reserve(256);
     m_legal_moves.reserve(256);
   }
 
@@ -119,7 +118,6 @@ namespace lilia::chess
   {
     m_position = Position{};
     m_result = GameResult::Ongoing;
-    m_pseudo_moves.clear();
     m_legal_moves.clear();
     m_stateHistory.clear();
 
@@ -261,21 +259,7 @@ namespace lilia::chess
 
   const std::vector<Move> &ChessGame::generateLegalMoves()
   {
-    m_pseudo_moves.clear();
-    m_legal_moves.clear();
-
-    m_move_gen.generatePseudoLegalMoves(m_position.getBoard(), m_position.getState(), m_pseudo_moves);
-
-    StateInfo scratch{};
-    for (const auto &m : m_pseudo_moves)
-    {
-      if (m_position.doMove(m, scratch))
-      {
-        m_position.undoMove();
-        m_legal_moves.push_back(m);
-      }
-    }
-
+    m_move_gen.generateLegalMoves(m_position.getBoard(), m_position.getState(), m_legal_moves);
     return m_legal_moves;
   }
 
@@ -348,7 +332,6 @@ namespace lilia::chess
         m_stateHistory.emplace_back();
         if (m_position.doMove(m, m_stateHistory.back()))
         {
-          m_pseudo_moves.clear();
           m_legal_moves.clear();
           return true;
         }
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <iostream>
@@ -24,29 +25,66 @@
 #endif
 #endif
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 namespace lilia::chess::magic
 {
 
+#ifdef LILIA_MAGIC_HAVE_CONSTANTS
+  // Entries and both arenas are used in place from .rodata: nothing is built or copied at
+  // startup. Calibration touches a few squares of each arena; set_backend() then drops the
+  // pages of the one not in use (Linux), which refault from the binary if it is picked later.
+  using generated::MagicEntry;
+  static constexpr const MagicEntry *g_rook_entry = generated::srook;
+  static constexpr const MagicEntry *g_bishop_entry = generated::sbishop;
+  static constexpr const bb::Bitboard *g_attack_arena = generated::sattack_arena;
+  static constexpr const bb::Bitboard *g_pext_arena = generated::spext_arena;
+
+  template <class T, class F>
+  static consteval std::array<T, SQ_NB> from_entries(const MagicEntry *entries, F field)
+  {
+    std::array<T, SQ_NB> out{};
+    for (int i = 0; i < SQ_NB; ++i)
+      out[i] = field(entries[i]);
+    return out;
+  }
+
+  static constexpr auto mask_of = [](const MagicEntry &e)
+  { return bb::Bitboard{e.mask}; };
+  static constexpr auto magic_of = [](const MagicEntry &e)
+  { return Magic{e.magic, e.shift}; };
+
+  static constexpr auto g_rook_mask = from_entries<bb::Bitboard>(generated::srook, mask_of);
+  static constexpr auto g_bishop_mask = from_entries<bb::Bitboard>(generated::sbishop, mask_of);
+  static constexpr auto g_rook_magic = from_entries<Magic>(generated::srook, magic_of);
+  static constexpr auto g_bishop_magic = from_entries<Magic>(generated::sbishop, magic_of);
+#else
+  // Bootstrap without generated constants: same layout, built at startup.
+  struct MagicEntry
+  {
+    bb::Bitboard mask;
+    bb::Bitboard magic;
+    std::uint32_t offset;
+    std::uint32_t pextOffset;
+    std::uint8_t shift;
+  };
+  static std::array<MagicEntry, SQ_NB> g_rook_entry{};
+  static std::array<MagicEntry, SQ_NB> g_bishop_entry{};
+  static std::vector<bb::Bitboard> g_attack_arena_rt, g_pext_arena_rt;
+  static const bb::Bitboard *g_attack_arena = nullptr;
+  static const bb::Bitboard *g_pext_arena = nullptr;
+
   static std::array<bb::Bitboard, SQ_NB> g_rook_mask{};
   static std::array<bb::Bitboard, SQ_NB> g_bishop_mask{};
-
   static std::array<Magic, SQ_NB> g_rook_magic{};
   static std::array<Magic, SQ_NB> g_bishop_magic{};
-
-  // Compatibility vector tables (can be dropped after packing; lazily reconstructable)
-  static std::array<std::vector<bb::Bitboard>, SQ_NB> g_rook_table;
-  static std::array<std::vector<bb::Bitboard>, SQ_NB> g_bishop_table;
-
-  // Flat arenas + offsets/lengths
-  static std::array<std::uint32_t, SQ_NB> g_r_off_magic{}, g_b_off_magic{};
-  static std::array<std::uint16_t, SQ_NB> g_r_len_magic{}, g_b_len_magic{};
-  static std::vector<bb::Bitboard> g_r_arena_magic, g_b_arena_magic;
-
-  static std::array<std::uint32_t, SQ_NB> g_r_off_pext{}, g_b_off_pext{};
-  static std::array<std::uint16_t, SQ_NB> g_r_len_pext{}, g_b_len_pext{};
-  static std::vector<bb::Bitboard> g_r_arena_pext, g_b_arena_pext;
+#endif
 
   static bool g_use_pext = false;
+  static BackendTiming g_timing{};
 
   // -------------------- helpers --------------------
 
@@ -76,6 +114,9 @@ namespace lilia::chess::magic
     return (s == Slider::Rook) ? brute_rook(sq, occ) : brute_bishop(sq, occ);
   }
 
+#ifndef LILIA_MAGIC_HAVE_CONSTANTS
+  // -------------------- magic search (only without generated constants) --------------------
+
   static inline std::uint64_t index_for_occ_checked(bb::Bitboard occ, bb::Bitboard mask,
                                                     bb::Bitboard magic, std::uint8_t shift)
   {
@@ -86,29 +127,6 @@ namespace lilia::chess::magic
     return static_cast<std::uint64_t>((subset * magic) >> shift);
   }
 
-  static LILIA_ALWAYS_INLINE std::uint32_t index_for_occ_fast(bb::Bitboard occ, bb::Bitboard mask,
-                                                              bb::Bitboard magic, std::uint8_t shift) noexcept
-  {
-    if (LILIA_UNLIKELY(shift >= SQ_NB))
-      return 0u;
-    const bb::Bitboard subset = occ & mask;
-    return static_cast<std::uint32_t>((subset * magic) >> shift);
-  }
-
-  static inline void build_table_for_square(Slider s, int sq, bb::Bitboard mask, bb::Bitboard magic,
-                                            std::uint8_t shift, std::vector<bb::Bitboard> &outTable)
-  {
-    const int bits = bb::popcount(mask);
-    const std::size_t tableSize = (bits == 0) ? 1ULL : (1ULL << bits);
-    outTable.assign(tableSize, 0ULL);
-
-    foreach_subset(mask, [&](bb::Bitboard occSubset)
-                   {
-    const std::uint64_t index = index_for_occ_checked(occSubset, mask, magic, shift);
-    outTable[static_cast<std::size_t>(index)] =
-        brute_attacks(s, static_cast<Square>(sq), occSubset); });
-  }
-
   static inline bool try_magic_for_square(Slider s, int sq, bb::Bitboard mask, bb::Bitboard magic,
                                           std::uint8_t shift, std::vector<bb::Bitboard> &outTable)
   {
@@ -249,7 +267,7 @@ namespace lilia::chess::magic
     }
   }
 
-  static inline void generate_all_magics_and_tables()
+  static inline void generate_all_magics()
   {
     build_masks();
 
@@ -261,7 +279,6 @@ namespace lilia::chess::magic
       const bb::Bitboard mask = g_rook_mask[sq];
       (void)find_magic_for_square(Slider::Rook, sq, mask, magic, shift, table);
       g_rook_magic[sq] = Magic{magic, shift};
-      g_rook_table[sq] = std::move(table);
     }
     for (int sq = 0; sq < SQ_NB; ++sq)
     {
@@ -271,87 +288,40 @@ namespace lilia::chess::magic
       const bb::Bitboard mask = g_bishop_mask[sq];
       (void)find_magic_for_square(Slider::Bishop, sq, mask, magic, shift, table);
       g_bishop_magic[sq] = Magic{magic, shift};
-      g_bishop_table[sq] = std::move(table);
     }
   }
 
-  static inline void pack_magic_vectors_to_flat(const std::array<std::vector<bb::Bitboard>, SQ_NB> &src,
-                                                std::array<std::uint32_t, SQ_NB> &off,
-                                                std::array<std::uint16_t, SQ_NB> &len,
-                                                std::vector<bb::Bitboard> &arena)
+  // Back-to-back layout in square order (the serializer puts the largest tables first). PEXT
+  // slot k holds the k-th subset of the mask in increasing order (carry-rippler enumeration).
+  static inline void build_arenas()
   {
     std::uint32_t cur = 0;
-
-    std::size_t total = 0;
-    for (int i = 0; i < SQ_NB; ++i)
-      total += src[i].empty() ? 1u : src[i].size();
-
-    arena.clear();
-    arena.resize(total);
-
-    for (int i = 0; i < SQ_NB; ++i)
+    auto place = [&](Slider s, const std::array<bb::Bitboard, SQ_NB> &masks,
+                     const std::array<Magic, SQ_NB> &magics, std::array<MagicEntry, SQ_NB> &entries)
     {
-      off[i] = cur;
-
-      if (src[i].empty())
+      for (int i = 0; i < SQ_NB; ++i)
       {
-        len[i] = 1;
-        arena[cur] = 0ULL;
-        ++cur;
-      }
-      else
-      {
-        const std::size_t sz = src[i].size();
-        len[i] = static_cast<std::uint16_t>(sz);
-        std::copy(src[i].begin(), src[i].end(), arena.begin() + cur);
-        cur += static_cast<std::uint32_t>(sz);
+        const bb::Bitboard mask = masks[i];
+        entries[i] = MagicEntry{mask, magics[i].magic, cur,
+                                static_cast<std::uint32_t>(g_pext_arena_rt.size()), magics[i].shift};
+        g_attack_arena_rt.resize(cur + (std::size_t{1} << bb::popcount(mask)), 0ULL);
+        bb::Bitboard sub = 0;
+        do
+        {
+          const bb::Bitboard atk = brute_attacks(s, static_cast<Square>(i), sub);
+          g_attack_arena_rt[cur + ((sub * magics[i].magic) >> magics[i].shift)] = atk;
+          g_pext_arena_rt.push_back(atk);
+          sub = (sub - mask) & mask;
+        } while (sub);
+        cur = static_cast<std::uint32_t>(g_attack_arena_rt.size());
       }
-    }
-  }
-
-#if defined(LILIA_HAVE_PEXT_INTRINSIC)
-  static inline void build_table_for_square_pext_into(bb::Bitboard mask, Slider s, int sq,
-                                                      bb::Bitboard *dst /* size = 1<<bits or 1 */)
-  {
-    const int bits = bb::popcount(mask);
-    const std::size_t size = (bits == 0) ? 1ULL : (1ULL << bits);
-    std::fill(dst, dst + size, 0ULL);
-
-    foreach_subset(mask, [&](bb::Bitboard sub)
-                   {
-    const std::uint64_t idx = _pext_u64(sub, mask);
-    dst[static_cast<std::size_t>(idx)] = brute_attacks(s, static_cast<Square>(sq), sub); });
-  }
-
-  static inline void build_all_pext_flat(std::array<std::uint32_t, SQ_NB> &off,
-                                         std::array<std::uint16_t, SQ_NB> &len,
-                                         std::vector<bb::Bitboard> &arena, Slider s)
-  {
-    std::uint32_t cur = 0;
-
-    std::size_t total = 0;
-    for (int i = 0; i < SQ_NB; ++i)
-    {
-      const bb::Bitboard mask = (s == Slider::Rook) ? g_rook_mask[i] : g_bishop_mask[i];
-      const int bits = bb::popcount(mask);
-      total += (bits == 0) ? 1ULL : (1ULL << bits);
-    }
-
-    arena.clear();
-    arena.resize(total);
-
-    for (int i = 0; i < SQ_NB; ++i)
-    {
-      const bb::Bitboard mask = (s == Slider::Rook) ? g_rook_mask[i] : g_bishop_mask[i];
-      const int bits = bb::popcount(mask);
-      const std::uint16_t L = static_cast<std::uint16_t>((bits == 0) ? 1u : (1u << bits));
-
-      off[i] = cur;
-      len[i] = L;
-
-      build_table_for_square_pext_into(mask, s, i, arena.data() + cur);
-      cur += L;
-    }
+    };
+    g_attack_arena_rt.clear();
+    g_pext_arena_rt.clear();
+    place(Slider::Rook, g_rook_mask, g_rook_magic, g_rook_entry);
+    place(Slider::Bishop, g_bishop_mask, g_bishop_magic, g_bishop_entry);
+    g_attack_arena = g_attack_arena_rt.data();
+    g_pext_arena = g_pext_arena_rt.data();
   }
 #endif
 
@@ -377,101 +347,165 @@ namespace lilia::chess::magic
 
   void init_magics()
   {
-#ifdef LILIA_MAGIC_HAVE_CONSTANTS
-    using namespace lilia::chess::magic::generated;
+#ifndef LILIA_MAGIC_HAVE_CONSTANTS
+    generate_all_magics();
+    build_arenas();
 
-    build_masks();
+    serialize_magics_to_header("include/lilia/chess/generated/magic_constants.hpp", g_rook_magic,
+                               g_bishop_magic, g_rook_mask, g_bishop_mask);
+#endif
 
-    for (int i = 0; i < SQ_NB; ++i)
-    {
-      g_rook_magic[i] = {srook_magic[i].magic, srook_magic[i].shift};
-      g_bishop_magic[i] = {sbishop_magic[i].magic, sbishop_magic[i].shift};
-    }
+    (void)select_fastest_backend();
+  }
 
-#ifdef LILIA_MAGIC_FLAT_CONSTANTS
-    for (int i = 0; i < SQ_NB; ++i)
-    {
-      g_r_off_magic[i] = srook_off[i];
-      g_r_len_magic[i] = srook_len[i];
-      g_b_off_magic[i] = sbishop_off[i];
-      g_b_len_magic[i] = sbishop_len[i];
-    }
-    g_r_arena_magic.assign(srook_arena, srook_arena + srook_arena_size);
-    g_b_arena_magic.assign(sbishop_arena, sbishop_arena + sbishop_arena_size);
-#else
-    for (int i = 0; i < SQ_NB; ++i)
-    {
-      g_rook_table[i] = srook_table[i];
-      g_bishop_table[i] = sbishop_table[i];
-    }
-    pack_magic_vectors_to_flat(g_rook_table, g_r_off_magic, g_r_len_magic, g_r_arena_magic);
-    pack_magic_vectors_to_flat(g_bishop_table, g_b_off_magic, g_b_len_magic, g_b_arena_magic);
+  static LILIA_ALWAYS_INLINE bb::Bitboard lookup_magic(Slider s, int i, bb::Bitboard occ) noexcept
+  {
+    const MagicEntry &e = (s == Slider::Rook) ? g_rook_entry[i] : g_bishop_entry[i];
+    return g_attack_arena[e.offset + static_cast<std::uint32_t>(((occ & e.mask) * e.magic) >> e.shift)];
+  }
+
+#if defined(LILIA_HAVE_PEXT_INTRINSIC)
+  static LILIA_ALWAYS_INLINE bb::Bitboard lookup_pext(Slider s, int i, bb::Bitboard occ) noexcept
+  {
+    const MagicEntry &e = (s == Slider::Rook) ? g_rook_entry[i] : g_bishop_entry[i];
+    return g_pext_arena[e.pextOffset + static_cast<std::uint32_t>(_pext_u64(occ, e.mask))];
+  }
 #endif
 
-#else
-    generate_all_magics_and_tables();
-    pack_magic_vectors_to_flat(g_rook_table, g_r_off_magic, g_r_len_magic, g_r_arena_magic);
-    pack_magic_vectors_to_flat(g_bishop_table, g_b_off_magic, g_b_len_magic, g_b_arena_magic);
+  bb::Bitboard sliding_attacks(Slider s, Square sq, bb::Bitboard occ) noexcept
+  {
+    const int i = static_cast<int>(sq);
 
-    serialize_magics_to_header("include/lilia/chess/generated/magic_constants.hpp");
+#if defined(LILIA_HAVE_PEXT_INTRINSIC)
+    if (LILIA_LIKELY(g_use_pext))
+      return lookup_pext(s, i, occ);
 #endif
 
-    g_use_pext = cpu_has_bmi2();
+    return lookup_magic(s, i, occ);
+  }
 
-#if defined(LILIA_HAVE_PEXT_INTRINSIC)
-    if (g_use_pext)
-    {
-      build_all_pext_flat(g_r_off_pext, g_r_len_pext, g_r_arena_pext, Slider::Rook);
-      build_all_pext_flat(g_b_off_pext, g_b_len_pext, g_b_arena_pext, Slider::Bishop);
-    }
+  // -------------------- backend selection --------------------
+
+  bool pext_available() noexcept
+  {
+    static const bool ok = cpu_has_bmi2();
+    return ok;
+  }
+
+  Backend backend() noexcept
+  {
+    return g_use_pext ? Backend::Pext : Backend::Magic;
+  }
+
+  // Unmaps the whole pages inside [p, p + n); the data is read-only, so nothing is lost.
+  [[maybe_unused]] static void release_pages(const void *p, std::size_t n) noexcept
+  {
+#if defined(__linux__)
+    const long pageSize = ::sysconf(_SC_PAGESIZE);
+    if (pageSize <= 0)
+      return;
+    const auto page = static_cast<std::uintptr_t>(pageSize);
+    const std::uintptr_t begin = (reinterpret_cast<std::uintptr_t>(p) + page - 1) & ~(page - 1);
+    const std::uintptr_t end = (reinterpret_cast<std::uintptr_t>(p) + n) & ~(page - 1);
+    if (end > begin)
+      (void)::madvise(reinterpret_cast<void *>(begin), end - begin, MADV_DONTNEED);
 #else
-    g_use_pext = false;
+    (void)p;
+    (void)n;
 #endif
+  }
+
+  bool set_backend(Backend b) noexcept
+  {
+    if (b == Backend::Pext && !pext_available())
+      return false;
 
-#if defined(NDEBUG)
-    for (auto &v : g_rook_table)
-      std::vector<bb::Bitboard>().swap(v);
-    for (auto &v : g_bishop_table)
-      std::vector<bb::Bitboard>().swap(v);
+    g_use_pext = (b == Backend::Pext);
+#if defined(LILIA_MAGIC_HAVE_CONSTANTS)
+    if (g_use_pext)
+      release_pages(generated::sattack_arena, sizeof(generated::sattack_arena));
+    else
+      release_pages(generated::spext_arena, sizeof(generated::spext_arena));
 #endif
+    return true;
   }
 
-  bb::Bitboard sliding_attacks(Slider s, Square sq, bb::Bitboard occ) noexcept
+  // Calibration squares: a corner, b2 and two centre squares. Timing every square faults in
+  // both arenas whole (~850 KB each) just to keep one of them.
+  static constexpr int CALIBRATION_SQUARES[] = {0, 9, 27, 36};
+
+  // Random (square, occupancy) queries, each occupancy feeding on the previous result so
+  // the loop measures lookup latency the way movegen and eval consume it.
+  template <class Lookup>
+  static double time_lookups(Lookup &&lookup)
   {
-    const int i = static_cast<int>(sq);
+    constexpr int QUERIES = 2048;
+    constexpr int ROUNDS = 4;
+    using clock = std::chrono::steady_clock;
 
-#if defined(LILIA_HAVE_PEXT_INTRINSIC)
-    if (LILIA_LIKELY(g_use_pext))
+    double best = 0.0;
+    for (int r = 0; r < ROUNDS; ++r)
     {
-      if (s == Slider::Rook)
+      random::SplitMix64 rng(0x5EEDF00DULL);
+      bb::Bitboard acc = 0;
+      const auto t0 = clock::now();
+      for (int q = 0; q < QUERIES; ++q)
       {
-        const std::uint32_t off = g_r_off_pext[i];
-        const std::uint64_t idx = _pext_u64(occ, g_rook_mask[i]);
-        return g_r_arena_pext[off + static_cast<std::uint32_t>(idx)];
+        const bb::Bitboard x = rng.next();
+        const int sq = CALIBRATION_SQUARES[x & 3];
+        const bb::Bitboard occ = (x & rng.next()) ^ (acc & 0xFF);
+        acc += lookup((x & 64) ? Slider::Rook : Slider::Bishop, sq, occ);
       }
-      else
+      const double ns =
+          static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count());
+      volatile bb::Bitboard sink = acc;
+      (void)sink;
+      const double perLookup = ns / QUERIES;
+      if (r == 0 || perLookup < best)
+        best = perLookup;
+    }
+    return best;
+  }
+
+  Backend select_fastest_backend()
+  {
+    g_timing = BackendTiming{};
+
+#if defined(LILIA_HAVE_PEXT_INTRINSIC)
+    if (pext_available())
+    {
+      // Interleaved so a clock ramp-up does not favour the second candidate.
+      double magicNs = 0.0, pextNs = 0.0;
+      for (int i = 0; i < 2; ++i)
       {
-        const std::uint32_t off = g_b_off_pext[i];
-        const std::uint64_t idx = _pext_u64(occ, g_bishop_mask[i]);
-        return g_b_arena_pext[off + static_cast<std::uint32_t>(idx)];
+        const double m = time_lookups([](Slider s, int sq, bb::Bitboard occ)
+                                      { return lookup_magic(s, sq, occ); });
+        const double p = time_lookups([](Slider s, int sq, bb::Bitboard occ)
+                                      { return lookup_pext(s, sq, occ); });
+        magicNs = (i == 0) ? m : std::min(magicNs, m);
+        pextNs = (i == 0) ? p : std::min(pextNs, p);
       }
+      g_timing = BackendTiming{magicNs, pextNs};
+
+      // Ties go to PEXT: its tables are the same size but need no multiply.
+      const Backend pick = (pextNs <= magicNs) ? Backend::Pext : Backend::Magic;
+      set_backend(pick);
+      return pick;
     }
 #endif
 
-    if (s == Slider::Rook)
-    {
-      const std::uint32_t off = g_r_off_magic[i];
-      const std::uint32_t idx =
-          index_for_occ_fast(occ, g_rook_mask[i], g_rook_magic[i].magic, g_rook_magic[i].shift);
-      return g_r_arena_magic[off + idx];
-    }
-    else
-    {
-      const std::uint32_t off = g_b_off_magic[i];
-      const std::uint32_t idx =
-          index_for_occ_fast(occ, g_bishop_mask[i], g_bishop_magic[i].magic, g_bishop_magic[i].shift);
-      return g_b_arena_magic[off + idx];
-    }
+    set_backend(Backend::Magic);
+    return Backend::Magic;
+  }
+
+  BackendTiming last_backend_timing() noexcept
+  {
+    return g_timing;
+  }
+
+  const char *backend_name(Backend b) noexcept
+  {
+    return b == Backend::Pext ? "pext" : "magic";
   }
 
   const std::array<bb::Bitboard, SQ_NB> &rook_masks()
@@ -491,41 +525,4 @@ namespace lilia::chess::magic
     return g_bishop_magic;
   }
 
-  static inline void materialize_rook_vectors_if_needed()
-  {
-    if (!g_rook_table[0].empty())
-      return;
-    for (int i = 0; i < SQ_NB; ++i)
-    {
-      const std::uint32_t off = g_r_off_magic[i];
-      const std::uint16_t L = g_r_len_magic[i];
-      g_rook_table[i].assign(g_r_arena_magic.begin() + off, g_r_arena_magic.begin() + off + L);
-    }
-  }
-  static inline void materialize_bishop_vectors_if_needed()
-  {
-    if (!g_bishop_table[0].empty())
-      return;
-    for (int i = 0; i < SQ_NB; ++i)
-    {
-      const std::uint32_t off = g_b_off_magic[i];
-      const std::uint16_t L = g_b_len_magic[i];
-      g_bishop_table[i].assign(g_b_arena_magic.begin() + off, g_b_arena_magic.begin() + off + L);
-    }
-  }
-
-  const std::array<std::vector<bb::Bitboard>, SQ_NB> &rook_tables()
-  {
-    if (LILIA_UNLIKELY(g_rook_table[0].empty()))
-      materialize_rook_vectors_if_needed();
-    return g_rook_table;
-  }
-
-  const std::array<std::vector<bb::Bitboard>, SQ_NB> &bishop_tables()
-  {
-    if (LILIA_UNLIKELY(g_bishop_table[0].empty()))
-      materialize_bishop_vectors_if_needed();
-    return g_bishop_table;
-  }
-
 }
@@ -1,174 +1,192 @@
 #include "lilia/chess/magic_serializer.hpp"
 
-#include <cstdio>
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
-#include <sstream>
+#include <numeric>
+#include <ostream>
 #include <string>
 #include <vector>
 
-#include "lilia/chess/core/magic.hpp"
+#include "lilia/chess/core/bitboard.hpp"
 
 namespace lilia::chess::magic
 {
 
-  static inline void write_u64_hex(std::ostream &os, std::uint64_t v)
+  namespace
   {
-    std::ios::fmtflags f(os.flags());
-    os << "0x" << std::hex << std::uppercase << v;
-    os.flags(f);
-  }
-
-  static inline void write_array_u32(std::ostream &os, const char *name,
-                                     const std::vector<std::uint32_t> &a, int per_line = 8)
-  {
-    os << "const std::uint32_t " << name << "[" << a.size() << "] = {\n  ";
-    for (size_t i = 0; i < a.size(); ++i)
+    struct SquareTable
     {
-      os << a[i];
-      if (i + 1 != a.size())
-        os << ", ";
-      if (per_line > 0 && ((int)((i + 1) % per_line) == 0) && i + 1 != a.size())
-        os << "\n  ";
+      Slider slider;
+      int sq;
+      Magic magic;
+      bb::Bitboard mask;
+      std::vector<std::uint32_t> idx; // used slots, relative to the table base
+      std::vector<bb::Bitboard> atk;  // attack set per used slot
+      std::uint32_t offset = 0;
+      std::uint32_t pextOffset = 0;
+    };
+
+    // Used slots of one fancy-magic table. Several occupancies may share a slot only if
+    // they produce the same attack set (constructive collision).
+    SquareTable collect(Slider s, int sq, bb::Bitboard mask, Magic m)
+    {
+      SquareTable t{s, sq, m, mask, {}, {}};
+      std::vector<std::pair<std::uint32_t, bb::Bitboard>> slots;
+      bb::Bitboard sub = 0;
+      do
+      {
+        const auto i = static_cast<std::uint32_t>((sub * m.magic) >> m.shift);
+        const bb::Bitboard a = (s == Slider::Rook) ? bb::rook_attacks(static_cast<Square>(sq), sub)
+                                                   : bb::bishop_attacks(static_cast<Square>(sq), sub);
+        slots.emplace_back(i, a);
+        sub = (sub - mask) & mask;
+      } while (sub);
+
+      std::sort(slots.begin(), slots.end());
+      slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+      for (const auto &[i, a] : slots)
+      {
+        t.idx.push_back(i);
+        t.atk.push_back(a);
+      }
+      return t;
     }
-    os << "\n};\n\n";
-  }
 
-  static inline void write_array_u16(std::ostream &os, const char *name,
-                                     const std::vector<std::uint16_t> &a, int per_line = 12)
-  {
-    os << "const std::uint16_t " << name << "[" << a.size() << "] = {\n  ";
-    for (size_t i = 0; i < a.size(); ++i)
+    // Tables go back to back, largest first so every table starts on a multiple of its own
+    // size. Each takes its full 2^bits slots: the minimal-shift magics leave only 8 of the
+    // 107648 slots unused, so letting tables overlap would save nothing.
+    std::vector<bb::Bitboard> pack(std::vector<SquareTable> &tables)
     {
-      os << a[i];
-      if (i + 1 != a.size())
-        os << ", ";
-      if (per_line > 0 && ((int)((i + 1) % per_line) == 0) && i + 1 != a.size())
-        os << "\n  ";
+      std::vector<std::size_t> order(tables.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b)
+                       { return tables[a].magic.shift < tables[b].magic.shift; });
+
+      std::vector<bb::Bitboard> arena;
+      for (std::size_t k : order)
+      {
+        SquareTable &t = tables[k];
+        t.offset = static_cast<std::uint32_t>(arena.size());
+        arena.resize(arena.size() + (std::size_t{1} << (64 - t.magic.shift)), 0);
+        for (std::size_t j = 0; j < t.idx.size(); ++j)
+          arena[t.offset + t.idx[j]] = t.atk[j];
+      }
+      return arena;
     }
-    os << "\n};\n\n";
-  }
 
-  static inline void write_array_u64(std::ostream &os, const char *name,
-                                     const std::vector<std::uint64_t> &a, int per_line = 4)
-  {
-    os << "const std::uint64_t " << name << "[" << a.size() << "] = {\n  ";
-    for (size_t i = 0; i < a.size(); ++i)
+    // PEXT tables need no search: slot k holds the k-th subset of the mask in increasing
+    // order, which is exactly what the carry-rippler enumeration yields.
+    std::vector<bb::Bitboard> pack_pext(std::vector<SquareTable> &tables)
     {
-      write_u64_hex(os, a[i]);
-      if (i + 1 != a.size())
-        os << ", ";
-      if (per_line > 0 && ((int)((i + 1) % per_line) == 0) && i + 1 != a.size())
-        os << "\n  ";
+      std::vector<bb::Bitboard> arena;
+      for (SquareTable &t : tables)
+      {
+        t.pextOffset = static_cast<std::uint32_t>(arena.size());
+        bb::Bitboard sub = 0;
+        do
+        {
+          arena.push_back((t.slider == Slider::Rook) ? bb::rook_attacks(static_cast<Square>(t.sq), sub)
+                                                     : bb::bishop_attacks(static_cast<Square>(t.sq), sub));
+          sub = (sub - t.mask) & t.mask;
+        } while (sub);
+      }
+      return arena;
     }
-    os << "\n};\n\n";
-  }
 
-  static inline void write_magic_array(std::ostream &os, const char *name,
-                                       const std::array<Magic, SQ_NB> &mag)
-  {
-    os << "const MagicPacked " << name << "[64] = {\n";
-    for (int i = 0; i < 64; ++i)
+    void write_u64_hex(std::ostream &os, std::uint64_t v)
     {
-      os << "  { ";
-      write_u64_hex(os, mag[i].magic);
-      os << ", " << (unsigned)mag[i].shift << " }";
-      if (i != 63)
-        os << ",";
-      os << "\n";
+      std::ios::fmtflags f(os.flags());
+      os << "0x" << std::hex << std::uppercase << v;
+      os.flags(f);
     }
-    os << "};\n\n";
-  }
 
-  static inline void pack_flat(const std::array<std::vector<std::uint64_t>, SQ_NB> &src,
-                               std::vector<std::uint32_t> &off, std::vector<std::uint16_t> &len,
-                               std::vector<std::uint64_t> &arena)
-  {
-    off.assign(SQ_NB, 0);
-    len.assign(SQ_NB, 0);
-    arena.clear();
-    arena.reserve(1 << 16);
-
-    std::uint32_t cur = 0;
-    for (int i = 0; i < SQ_NB; ++i)
+    void write_arena(std::ostream &os, const char *name, const std::vector<bb::Bitboard> &arena)
     {
-      const auto &v = src[i];
-      off[i] = cur;
-      const std::uint16_t L =
-          static_cast<std::uint16_t>(v.empty() ? 1u : static_cast<unsigned>(v.size()));
-      len[i] = L;
-
-      if (v.empty())
+      os << "    inline constexpr std::size_t " << name << "_size = " << arena.size() << ";\n\n";
+      os << "    alignas(64) inline constexpr std::uint64_t " << name << "[" << arena.size() << "] = {";
+      for (std::size_t i = 0; i < arena.size(); ++i)
       {
-        arena.push_back(0ULL);
-        ++cur;
+        os << ((i % 4 == 0) ? "\n        " : " ");
+        write_u64_hex(os, arena[i]);
+        os << ",";
       }
-      else
+      os << "\n    };\n\n";
+    }
+
+    void write_entries(std::ostream &os, const char *name, const std::vector<SquareTable> &tables,
+                       Slider s)
+    {
+      os << "    alignas(64) inline constexpr MagicEntry " << name << "[64] = {\n";
+      for (const SquareTable &t : tables)
       {
-        arena.insert(arena.end(), v.begin(), v.end());
-        cur += L;
+        if (t.slider != s)
+          continue;
+        os << "        {";
+        write_u64_hex(os, t.mask);
+        os << ", ";
+        write_u64_hex(os, t.magic.magic);
+        os << ", " << t.offset << ", " << t.pextOffset << ", " << static_cast<unsigned>(t.magic.shift)
+         << "},\n";
       }
+      os << "    };\n\n";
     }
   }
 
-  void serialize_magics_to_header(const std::string &outPath)
+  std::size_t serialize_magics_to_header(const std::string &outPath,
+                                         const std::array<Magic, SQ_NB> &rook,
+                                         const std::array<Magic, SQ_NB> &bishop,
+                                         const std::array<bb::Bitboard, SQ_NB> &rookMask,
+                                         const std::array<bb::Bitboard, SQ_NB> &bishopMask)
   {
-    // Daten aus der aktuellen Runtime übernehmen
-    const auto &rmag = rook_magics();
-    const auto &bmag = bishop_magics();
-    const auto &rtab = rook_tables();
-    const auto &btab = bishop_tables();
+    std::vector<SquareTable> tables;
+    tables.reserve(2 * SQ_NB);
+    for (int sq = 0; sq < SQ_NB; ++sq)
+      tables.push_back(collect(Slider::Rook, sq, rookMask[sq], rook[sq]));
+    for (int sq = 0; sq < SQ_NB; ++sq)
+      tables.push_back(collect(Slider::Bishop, sq, bishopMask[sq], bishop[sq]));
 
-    // In flache Arenen packen
-    std::vector<std::uint32_t> r_off(SQ_NB), b_off(SQ_NB);
-    std::vector<std::uint16_t> r_len(SQ_NB), b_len(SQ_NB);
-    std::vector<std::uint64_t> r_arena, b_arena;
-
-    pack_flat(rtab, r_off, r_len, r_arena);
-    pack_flat(btab, b_off, b_len, b_arena);
+    const std::vector<bb::Bitboard> arena = pack(tables);
+    const std::vector<bb::Bitboard> pextArena = pack_pext(tables);
 
     std::ofstream os(outPath, std::ios::out | std::ios::trunc);
     if (!os)
-    {
-      return;
-    }
+      return 0;
 
     os << R"(#pragma once
-// AUTO-GENERATED by Lilia magic_serializer.cpp
-// Contains flat-packed magic attack tables for rook & bishop.
-// This file can be checked into the repo for faster startup.
+// AUTO-GENERATED by magic_serializer.cpp (serialize_magics_to_header), do not edit.
+// Fancy magics for rook & bishop: per-square {mask, magic, offset, pextOffset, shift} into
+// one attack arena shared by both sliders, tables back to back, largest first.
+// Lookup: sattack_arena[offset + (((occ & mask) * magic) >> shift)]
+// or, with BMI2, spext_arena[pextOffset + pext(occ, mask)].
 
-#include <cstdint>
 #include <cstddef>
+#include <cstdint>
 
 #define LILIA_MAGIC_HAVE_CONSTANTS 1
-#define LILIA_MAGIC_FLAT_CONSTANTS 1
 
-namespace lilia::model::magic::constants {
+namespace lilia::chess::magic::generated
+{
 
-struct MagicPacked { std::uint64_t magic; std::uint8_t shift; };
+    struct MagicEntry
+    {
+        std::uint64_t mask;
+        std::uint64_t magic;
+        std::uint32_t offset;
+        std::uint32_t pextOffset;
+        std::uint8_t shift;
+    };
 
 )";
 
-    write_magic_array(os, "srook_magic", rmag);
-    write_magic_array(os, "sbishop_magic", bmag);
-
-    // Offsets/Lengths
-    write_array_u32(os, "srook_off", r_off);
-    write_array_u16(os, "srook_len", r_len);
-    write_array_u32(os, "sbishop_off", b_off);
-    write_array_u16(os, "sbishop_len", b_len);
-
-    // Arena sizes
-    os << "inline constexpr std::size_t srook_arena_size = " << r_arena.size() << ";\n";
-    os << "inline constexpr std::size_t sbishop_arena_size = " << b_arena.size() << ";\n\n";
-
-    // Arena
-    write_array_u64(os, "srook_arena", r_arena);
-    write_array_u64(os, "sbishop_arena", b_arena);
+    write_entries(os, "srook", tables, Slider::Rook);
+    write_entries(os, "sbishop", tables, Slider::Bishop);
 
-    os << "} // namespace lilia::model::magic::constants\n";
+    write_arena(os, "sattack_arena", arena);
+    write_arena(os, "spext_arena", pextArena);
+    os << "}\n";
     os.flush();
+    return os ? arena.size() : 0;
   }
 
 }
@@ -25,10 +25,13 @@ namespace lilia::chess
 
     enum class GenMode : std::uint8_t
     {
-      // All pseudo-legal moves (but with pin filtering and king-safety filtering for king moves).
+      // All legal moves: pins, the check-block mask, king safety and en-passant discovered
+      // checks are resolved during generation, nothing is left for the make step.
       All,
-      // Captures plus ALL promotions (quiet and capture promos), plus en-passant.
-      CapturesPlusPromos
+      // The legal captures plus ALL promotions (quiet and capture promos), plus en-passant.
+      CapturesPlusPromos,
+      // The complement: legal non-capturing, non-promoting moves including castling.
+      Quiets
     };
 
     LILIA_ALWAYS_INLINE SideSets side_sets(const Board &b, Color c) noexcept
@@ -286,7 +289,7 @@ namespace lilia::chess
       {
         const bb::Bitboard one = bb::north(our.pawns) & empty;
 
-        if constexpr (Mode == GenMode::All)
+        if constexpr (Mode != GenMode::CapturesPlusPromos)
         {
           const bb::Bitboard quietPush = (one & ~bb::RANK_8) & targetMask;
           const bb::Bitboard dbl = (bb::north(one & bb::RANK_3) & empty) & targetMask;
@@ -318,6 +321,7 @@ namespace lilia::chess
           }
         }
 
+        if constexpr (Mode != GenMode::Quiets)
         {
           const bb::Bitboard capL = ((bb::nw(our.pawns) & them) & ~bb::RANK_8) & targetMask;
           const bb::Bitboard capR = ((bb::ne(our.pawns) & them) & ~bb::RANK_8) & targetMask;
@@ -349,6 +353,7 @@ namespace lilia::chess
           }
         }
 
+        if constexpr (Mode != GenMode::Quiets)
         {
           const bb::Bitboard promoPush = (one & bb::RANK_8) & targetMask;
           for (bb::Bitboard pp = promoPush; pp;)
@@ -398,7 +403,7 @@ namespace lilia::chess
       {
         const bb::Bitboard one = bb::south(our.pawns) & empty;
 
-        if constexpr (Mode == GenMode::All)
+        if constexpr (Mode != GenMode::CapturesPlusPromos)
         {
           const bb::Bitboard quietPush = (one & ~bb::RANK_1) & targetMask;
           const bb::Bitboard dbl = (bb::south(one & bb::RANK_6) & empty) & targetMask;
@@ -430,6 +435,7 @@ namespace lilia::chess
           }
         }
 
+        if constexpr (Mode != GenMode::Quiets)
         {
           const bb::Bitboard capL = ((bb::se(our.pawns) & them) & ~bb::RANK_1) & targetMask;
           const bb::Bitboard capR = ((bb::sw(our.pawns) & them) & ~bb::RANK_1) & targetMask;
@@ -461,6 +467,7 @@ namespace lilia::chess
           }
         }
 
+        if constexpr (Mode != GenMode::Quiets)
         {
           const bb::Bitboard promoPush = (one & bb::RANK_1) & targetMask;
           for (bb::Bitboard pp = promoPush; pp;)
@@ -507,7 +514,7 @@ namespace lilia::chess
         }
       }
 
-      if constexpr (IncludeEP)
+      if constexpr (IncludeEP && Mode != GenMode::Quiets)
       {
         if (st.enPassantSquare != NO_SQUARE)
         {
@@ -569,8 +576,9 @@ namespace lilia::chess
       {
         const Square from = bb::pop_lsb_unchecked(knights);
         const bb::Bitboard atk = bb::knight_attacks_from(from) & targetMask;
-        out = emit_targets<true>(out, from, atk & enemyNoK);
-        if constexpr (Mode == GenMode::All)
+        if constexpr (Mode != GenMode::Quiets)
+          out = emit_targets<true>(out, from, atk & enemyNoK);
+        if constexpr (Mode != GenMode::CapturesPlusPromos)
           out = emit_targets<false>(out, from, atk & quietMask);
       }
 
@@ -594,8 +602,9 @@ namespace lilia::chess
       {
         const Square from = bb::pop_lsb_unchecked(freeBishops);
         const bb::Bitboard atk = magic::sliding_attacks(magic::Slider::Bishop, from, occ) & targetMask;
-        out = emit_targets<true>(out, from, atk & enemyNoK);
-        if constexpr (Mode == GenMode::All)
+        if constexpr (Mode != GenMode::Quiets)
+          out = emit_targets<true>(out, from, atk & enemyNoK);
+        if constexpr (Mode != GenMode::CapturesPlusPromos)
           out = emit_targets<false>(out, from, atk & quietMask);
       }
 
@@ -607,8 +616,9 @@ namespace lilia::chess
             magic::sliding_attacks(magic::Slider::Bishop, from, occ) &
             targetMask &
             pins.allow_mask(from);
-        out = emit_targets<true>(out, from, atk & enemyNoK);
-        if constexpr (Mode == GenMode::All)
+        if constexpr (Mode != GenMode::Quiets)
+          out = emit_targets<true>(out, from, atk & enemyNoK);
+        if constexpr (Mode != GenMode::CapturesPlusPromos)
           out = emit_targets<false>(out, from, atk & quietMask);
       }
 
@@ -632,8 +642,9 @@ namespace lilia::chess
       {
         const Square from = bb::pop_lsb_unchecked(freeRooks);
         const bb::Bitboard atk = magic::sliding_attacks(magic::Slider::Rook, from, occ) & targetMask;
-        out = emit_targets<true>(out, from, atk & enemyNoK);
-        if constexpr (Mode == GenMode::All)
+        if constexpr (Mode != GenMode::Quiets)
+          out = emit_targets<true>(out, from, atk & enemyNoK);
+        if constexpr (Mode != GenMode::CapturesPlusPromos)
           out = emit_targets<false>(out, from, atk & quietMask);
       }
 
@@ -645,8 +656,9 @@ namespace lilia::chess
             magic::sliding_attacks(magic::Slider::Rook, from, occ) &
             targetMask &
             pins.allow_mask(from);
-        out = emit_targets<true>(out, from, atk & enemyNoK);
-        if constexpr (Mode == GenMode::All)
+        if constexpr (Mode != GenMode::Quiets)
+          out = emit_targets<true>(out, from, atk & enemyNoK);
+        if constexpr (Mode != GenMode::CapturesPlusPromos)
           out = emit_targets<false>(out, from, atk & quietMask);
       }
 
@@ -670,8 +682,9 @@ namespace lilia::chess
       {
         const Square from = bb::pop_lsb_unchecked(freeQueens);
         const bb::Bitboard atk = queen_attacks_from(from, occ) & targetMask;
-        out = emit_targets<true>(out, from, atk & enemyNoK);
-        if constexpr (Mode == GenMode::All)
+        if constexpr (Mode != GenMode::Quiets)
+          out = emit_targets<true>(out, from, atk & enemyNoK);
+        if constexpr (Mode != GenMode::CapturesPlusPromos)
           out = emit_targets<false>(out, from, atk & quietMask);
       }
 
@@ -683,8 +696,9 @@ namespace lilia::chess
             queen_attacks_from(from, occ) &
             targetMask &
             pins.allow_mask(from);
-        out = emit_targets<true>(out, from, atk & enemyNoK);
-        if constexpr (Mode == GenMode::All)
+        if constexpr (Mode != GenMode::Quiets)
+          out = emit_targets<true>(out, from, atk & enemyNoK);
+        if constexpr (Mode != GenMode::CapturesPlusPromos)
           out = emit_targets<false>(out, from, atk & quietMask);
       }
 
@@ -708,15 +722,18 @@ namespace lilia::chess
       const bb::Bitboard occ_no_king = occ & ~fromBB;
       const Color them = ~Side;
 
-      for (bb::Bitboard caps = atk & enemyNoK; caps;)
+      if constexpr (Mode != GenMode::Quiets)
       {
-        const Square to = bb::pop_lsb_unchecked(caps);
-        const bb::Bitboard occ2 = occ_no_king & ~bb::sq_bb(to);
-        if (!attackedBy(board, to, them, occ2))
-          out = emit_move<true>(out, from, to);
+        for (bb::Bitboard caps = atk & enemyNoK; caps;)
+        {
+          const Square to = bb::pop_lsb_unchecked(caps);
+          const bb::Bitboard occ2 = occ_no_king & ~bb::sq_bb(to);
+          if (!attackedBy(board, to, them, occ2))
+            out = emit_move<true>(out, from, to);
+        }
       }
 
-      if constexpr (Mode == GenMode::All)
+      if constexpr (Mode != GenMode::CapturesPlusPromos)
       {
         for (bb::Bitboard quiet = atk & ~occ; quiet;)
         {
@@ -944,6 +961,24 @@ namespace lilia::chess
 
       return out;
     }
+
+    // Strictly legal output: checkers are found first and, when present, only evasions
+    // (king moves + capture/block of a single checker) are emitted; otherwise pinned
+    // pieces stay on their pin ray and king moves are tested with the king lifted off
+    // the board. Nothing needs a make/unmake legality test afterwards.
+    template <GenMode Mode>
+    LILIA_ALWAYS_INLINE Move *generateLegal_T(Move *LILIA_RESTRICT out,
+                                              const Board &b, const GameState &st) noexcept
+    {
+      const bb::Bitboard occ = b.getAllPieces();
+      const bb::Bitboard checkers = compute_checkers(b, st.sideToMove, occ);
+
+      if (st.sideToMove == Color::White)
+        return checkers ? generateEvasions_T<Color::White>(out, b, st, occ, checkers)
+                        : generate_all_regular_T<Color::White, Mode>(out, b, st, occ);
+      return checkers ? generateEvasions_T<Color::Black>(out, b, st, occ, checkers)
+                      : generate_all_regular_T<Color::Black, Mode>(out, b, st, occ);
+    }
   }
 
   void MoveGenerator::generateNonCapturePromotions(const Board &b, const GameState &st,
@@ -1028,44 +1063,33 @@ namespace lilia::chess
     return buf.size() - before;
   }
 
-  void MoveGenerator::generatePseudoLegalMoves(const Board &b, const GameState &st,
-                                               std::vector<Move> &out) const
+  void MoveGenerator::generateLegalMoves(const Board &b, const GameState &st,
+                                         std::vector<Move> &out) const
   {
     std::array<Move, MAX_MOVES> tmp{};
     MoveBuffer buf(tmp.data(), MAX_MOVES);
 
-    const bb::Bitboard occ = b.getAllPieces();
-    const bb::Bitboard checkers = compute_checkers(b, st.sideToMove, occ);
-
-    Move *ptr = buf.current();
-    if (st.sideToMove == Color::White)
-      ptr = checkers ? generateEvasions_T<Color::White>(ptr, b, st, occ, checkers)
-                     : generate_all_regular_T<Color::White, GenMode::All>(ptr, b, st, occ);
-    else
-      ptr = checkers ? generateEvasions_T<Color::Black>(ptr, b, st, occ, checkers)
-                     : generate_all_regular_T<Color::Black, GenMode::All>(ptr, b, st, occ);
-
-    buf.advance_to(ptr);
+    buf.advance_to(generateLegal_T<GenMode::All>(buf.current(), b, st));
     out.assign(tmp.data(), tmp.data() + buf.size());
   }
 
-  int MoveGenerator::generatePseudoLegalMoves(const Board &b, const GameState &st,
-                                              MoveBuffer &buf)
+  int MoveGenerator::generateLegalMoves(const Board &b, const GameState &st, MoveBuffer &buf)
   {
     const int before = buf.size();
-    const bb::Bitboard occ = b.getAllPieces();
-    const bb::Bitboard checkers = compute_checkers(b, st.sideToMove, occ);
+    buf.advance_to(generateLegal_T<GenMode::All>(buf.current(), b, st));
+    return buf.size() - before;
+  }
 
-    Move *ptr = buf.current();
-    if (st.sideToMove == Color::White)
-      ptr = checkers ? generateEvasions_T<Color::White>(ptr, b, st, occ, checkers)
-                     : generate_all_regular_T<Color::White, GenMode::All>(ptr, b, st, occ);
-    else
-      ptr = checkers ? generateEvasions_T<Color::Black>(ptr, b, st, occ, checkers)
-                     : generate_all_regular_T<Color::Black, GenMode::All>(ptr, b, st, occ);
+  void MoveGenerator::generatePseudoLegalMoves(const Board &b, const GameState &st,
+                                               std::vector<Move> &out) const
+  {
+    generateLegalMoves(b, st, out);
+  }
 
-    buf.advance_to(ptr);
-    return buf.size() - before;
+  int MoveGenerator::generatePseudoLegalMoves(const Board &b, const GameState &st,
+                                              MoveBuffer &buf)
+  {
+    return generateLegalMoves(b, st, buf);
   }
 
   void MoveGenerator::generateTacticalMoves(const Board &b, const GameState &st,
@@ -1074,35 +1098,30 @@ namespace lilia::chess
     std::array<Move, MAX_MOVES> tmp{};
     MoveBuffer buf(tmp.data(), MAX_MOVES);
 
-    const bb::Bitboard occ = b.getAllPieces();
-    const bb::Bitboard checkers = compute_checkers(b, st.sideToMove, occ);
-
-    Move *ptr = buf.current();
-    if (st.sideToMove == Color::White)
-      ptr = checkers ? generateEvasions_T<Color::White>(ptr, b, st, occ, checkers)
-                     : generate_all_regular_T<Color::White, GenMode::CapturesPlusPromos>(ptr, b, st, occ);
-    else
-      ptr = checkers ? generateEvasions_T<Color::Black>(ptr, b, st, occ, checkers)
-                     : generate_all_regular_T<Color::Black, GenMode::CapturesPlusPromos>(ptr, b, st, occ);
-
-    buf.advance_to(ptr);
+    buf.advance_to(generateLegal_T<GenMode::CapturesPlusPromos>(buf.current(), b, st));
     out.assign(tmp.data(), tmp.data() + buf.size());
   }
 
   int MoveGenerator::generateTacticalMoves(const Board &b, const GameState &st,
                                            MoveBuffer &buf)
+  {
+    const int before = buf.size();
+    buf.advance_to(generateLegal_T<GenMode::CapturesPlusPromos>(buf.current(), b, st));
+    return buf.size() - before;
+  }
+
+  int MoveGenerator::generateQuietMoves(const Board &b, const GameState &st, MoveBuffer &buf)
   {
     const int before = buf.size();
     const bb::Bitboard occ = b.getAllPieces();
-    const bb::Bitboard checkers = compute_checkers(b, st.sideToMove, occ);
+    if (compute_checkers(b, st.sideToMove, occ))
+      return 0;
 
     Move *ptr = buf.current();
     if (st.sideToMove == Color::White)
-      ptr = checkers ? generateEvasions_T<Color::White>(ptr, b, st, occ, checkers)
-                     : generate_all_regular_T<Color::White, GenMode::CapturesPlusPromos>(ptr, b, st, occ);
+      ptr = generate_all_regular_T<Color::White, GenMode::Quiets>(ptr, b, st, occ);
     else
-      ptr = checkers ? generateEvasions_T<Color::Black>(ptr, b, st, occ, checkers)
-                     : generate_all_regular_T<Color::Black, GenMode::CapturesPlusPromos>(ptr, b, st, occ);
+      ptr = generate_all_regular_T<Color::Black, GenMode::Quiets>(ptr, b, st, occ);
 
     buf.advance_to(ptr);
     return buf.size() - before;
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
 
 #include "lilia/chess/core/magic.hpp"
 #include "lilia/chess/move_generator.hpp"
@@ -364,23 +365,13 @@ namespace lilia::chess
     return false;
   }
 
-  bool Position::doMove(const Move &m, StateInfo &newState)
+  void Position::makeMove(const Move &m, const Piece &moved, StateInfo &newState)
   {
-    if (LILIA_UNLIKELY(&newState == m_st))
-      return false;
-
-    if (LILIA_UNLIKELY(!isPseudoLegal(m)))
-      return false;
-
-    const auto fromPiece = m_board.getPiece(m.from());
-    if (LILIA_UNLIKELY(!fromPiece || fromPiece->color != m_st->sideToMove))
-      return false;
-
     newState = *m_st;
     newState.previous = m_st;
     newState.move = m;
-    newState.moved = *fromPiece;
-    newState.captured = Piece{PieceType::None, ~fromPiece->color};
+    newState.moved = moved;
+    newState.captured = Piece{PieceType::None, ~moved.color};
     newState.capturedSquare = NO_SQUARE;
     newState.rookFrom = NO_SQUARE;
     newState.rookTo = NO_SQUARE;
@@ -390,6 +381,21 @@ namespace lilia::chess
         static_cast<std::uint16_t>(m_st->isNullMove() ? 1 : (m_st->pliesFromNull + 1));
 
     applyMove(m, newState);
+  }
+
+  bool Position::doMove(const Move &m, StateInfo &newState)
+  {
+    if (LILIA_UNLIKELY(&newState == m_st))
+      return false;
+
+    if (LILIA_UNLIKELY(!isPseudoLegal(m)))
+      return false;
+
+    const auto fromPiece = m_board.getPiece(m.from());
+    if (LILIA_UNLIKELY(!fromPiece || fromPiece->color != m_st->sideToMove))
+      return false;
+
+    makeMove(m, *fromPiece, newState);
 
     const Color movedSide = newState.moved.color;
     const bb::Bitboard kbb = m_board.getPieces(movedSide, PieceType::King);
@@ -410,6 +416,18 @@ namespace lilia::chess
     return true;
   }
 
+  void Position::doLegalMove(const Move &m, StateInfo &newState)
+  {
+    assert(&newState != m_st);
+    assert(isPseudoLegal(m));
+
+    const auto fromPiece = m_board.getPiece(m.from());
+    assert(fromPiece && fromPiece->color == m_st->sideToMove);
+
+    makeMove(m, *fromPiece, newState);
+    m_st = &newState;
+  }
+
   void Position::undoMove()
   {
     if (!m_st->previous)
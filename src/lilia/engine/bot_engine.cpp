@@ -3,11 +3,8 @@
 #define LOG 1
 
 #include <chrono>
-#include <condition_variable>
 #include <iostream>
 #include <memory>
-#include <mutex>
-#include <thread>
 
 #include "lilia/chess/chess_game.hpp"
 #include "lilia/protocol/uci/uci_helper.hpp"
@@ -35,46 +32,24 @@ namespace lilia::engine
   }
   SearchResult BotEngine::findBestMove(chess::ChessGame &gameState, int maxDepth, int thinkMillis,
                                        std::atomic<bool> *externalCancel)
+  {
+    TimeLimits lim;
+    if (thinkMillis > 0)
+      lim.moveTime = thinkMillis;
+    return findBestMove(gameState, maxDepth, lim, externalCancel);
+  }
+
+  SearchResult BotEngine::findBestMove(chess::ChessGame &gameState, int maxDepth, const TimeLimits &limits,
+                                       std::atomic<bool> *externalCancel)
   {
     SearchResult res;
     auto pos = gameState.getPositionRefForBot();
 
     auto stopFlag = std::make_shared<std::atomic<bool>>(false);
 
-    std::mutex m;
-    std::condition_variable cv;
-    bool timerStop = false;
-
-    std::thread timer([&]()
-                      {
-    auto checkCancel = [&]() {
-      if (externalCancel && externalCancel->load()) {
-        stopFlag->store(true);
-        return true;
-      }
-      return false;
-    };
-
-    if (thinkMillis <= 0) {
-      while (true) {
-        std::unique_lock<std::mutex> lk(m);
-        cv.wait_for(lk, std::chrono::milliseconds(50), [&] { return timerStop; });
-        if (timerStop) return;
-        if (checkCancel()) return;
-      }
-    }
-
-    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(thinkMillis);
-    while (true) {
-      std::unique_lock<std::mutex> lk(m);
-      cv.wait_for(lk, std::chrono::milliseconds(50), [&] { return timerStop; });
-      if (timerStop) return;
-      if (checkCancel()) return;
-      if (std::chrono::steady_clock::now() >= deadline) {
-        stopFlag->store(true);
-        return;
-      }
-    } });
+    // Deadlines and cancel are checked by the search itself on node ticks.
+    TimeManager tm;
+    tm.start(limits);
 
     using steady_clock = std::chrono::steady_clock;
     auto t0 = steady_clock::now();
@@ -84,7 +59,7 @@ namespace lilia::engine
 
     try
     {
-      auto mv = m_engine.find_best_move(pos, maxDepth, stopFlag);
+      auto mv = m_engine.find_best_move(pos, maxDepth, stopFlag, &tm, externalCancel);
       res.bestMove = mv; // std::optional<Move>
     }
     catch (const std::exception &e)
@@ -105,14 +80,6 @@ namespace lilia::engine
     auto t1 = steady_clock::now();
     long long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
 
-    {
-      std::lock_guard<std::mutex> lk(m);
-      timerStop = true;
-    }
-    cv.notify_one();
-    if (timer.joinable())
-      timer.join();
-
     // only adapt stats, when engine succeeded
     if (!engineThrew)
     {
@@ -135,17 +102,22 @@ namespace lilia::engine
     {
       reason = std::string("exception: ") + engineErr;
     }
-    else if (stopFlag->load() && thinkMillis > 0 && elapsedMs >= thinkMillis)
+    else if (tm.active() && elapsedMs >= tm.hard_ms())
     {
       reason = "timeout";
     }
+    else if (tm.active())
+    {
+      reason = "soft-limit";
+    }
     else
     {
       reason = "normal";
     }
     std::cout << "\n[BotEngine] Search finished: reason=" << reason << "\n";
     std::cout << "[BotEngine] depth=" << maxDepth << " time=" << elapsedMs
-              << "ms maxTime=" << thinkMillis << "ms threads=" << m_engine.getConfig().threads
+              << "ms soft=" << tm.soft_ms() << "ms hard=" << tm.hard_ms()
+              << "ms threads=" << m_engine.getConfig().threads
               << "\n";
 
     std::cout << "[BotEngine] info nodes=" << res.stats.nodes
@@ -186,4 +158,14 @@ namespace lilia::engine
     return m_engine.getLastSearchStats();
   }
 
+  void BotEngine::setConfig(const EngineConfig &cfg)
+  {
+    m_engine.setConfig(cfg);
+  }
+
+  void BotEngine::newGame()
+  {
+    m_engine.newGame();
+  }
+
 }
@@ -0,0 +1,340 @@
+#include "lilia/engine/endgame.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#include "lilia/chess/core/bitboard.hpp"
+#include "lilia/chess/core/magic.hpp"
+#include "lilia/chess/compiler.hpp"
+#include "lilia/engine/eval_alias.hpp"
+
+namespace lilia::engine::endgame
+{
+  namespace
+  {
+    using BB = chess::bb::Bitboard;
+
+    constexpr int KPK_WIN_BONUS = 200;
+    constexpr int KPK_RANK_BONUS = 20;   // per rank the pawn has advanced
+    constexpr int KBNK_CORNER_BONUS = 30; // per step closer to a right corner
+    constexpr int KBNK_KING_BONUS = 10;   // per step the kings are closer
+
+    // KPK with white owning the pawn on files a-d: stm | bk << 1 | wk << 7 | pawn << 13,
+    // pawn = (rank - 1) * 4 + file for ranks 2-7.
+    constexpr int KPK_SIZE = 2 * 64 * 64 * 24;
+    std::array<std::uint32_t, KPK_SIZE / 32> g_kpkWin{};
+
+    enum KpkResult : std::uint8_t
+    {
+      KPK_UNKNOWN = 0,
+      KPK_INVALID = 1,
+      KPK_DRAW = 2,
+      KPK_WIN = 4
+    };
+
+    constexpr int KPK_WHITE = 0, KPK_BLACK = 1;
+
+    LILIA_ALWAYS_INLINE int kpk_index(int stm, int wk, int bk, int psq) noexcept
+    {
+      const int p = ((psq >> 3) - 1) * 4 + (psq & 7);
+      return stm | (bk << 1) | (wk << 7) | (p << 13);
+    }
+
+    LILIA_ALWAYS_INLINE BB king_att(int sq) noexcept
+    {
+      return chess::bb::king_attacks_from(static_cast<chess::Square>(sq));
+    }
+
+    LILIA_ALWAYS_INLINE BB bit(int sq) noexcept
+    {
+      return chess::bb::sq_bb(static_cast<chess::Square>(sq));
+    }
+
+    KpkResult kpk_initial(int stm, int wk, int bk, int psq) noexcept
+    {
+      const BB wkA = king_att(wk);
+      const BB pawnAtt = chess::bb::white_pawn_attacks(bit(psq));
+
+      if (wk == bk || wk == psq || bk == psq || (wkA & bit(bk)))
+        return KPK_INVALID;
+      if (stm == KPK_WHITE && (pawnAtt & bit(bk)))
+        return KPK_INVALID;
+
+      if (stm == KPK_WHITE && (psq >> 3) == 6)
+      {
+        const int promo = psq + 8;
+        if (wk != promo && bk != promo && (!(king_att(bk) & bit(promo)) || (wkA & bit(promo))))
+          return KPK_WIN;
+      }
+
+      if (stm == KPK_BLACK)
+      {
+        const BB bkA = king_att(bk);
+        if (!(bkA & ~(wkA | pawnAtt)))
+          return KPK_DRAW; // stalemate
+        if (bkA & bit(psq) & ~wkA)
+          return KPK_DRAW; // takes the pawn
+      }
+
+      return KPK_UNKNOWN;
+    }
+
+    KpkResult kpk_step(const std::vector<std::uint8_t> &res, int stm, int wk, int bk, int psq) noexcept
+    {
+      bool unknown = false;
+
+      if (stm == KPK_WHITE)
+      {
+        auto visit = [&](int idx)
+        {
+          if (res[idx] == KPK_WIN)
+            return true;
+          unknown |= res[idx] == KPK_UNKNOWN;
+          return false;
+        };
+
+        BB to = king_att(wk) & ~king_att(bk) & ~bit(psq);
+        while (to)
+        {
+          const int s = chess::bb::ctz64(to);
+          to &= to - 1;
+          if (visit(kpk_index(KPK_BLACK, s, bk, psq)))
+            return KPK_WIN;
+        }
+
+        // Promotions are settled by kpk_initial.
+        const int push = psq + 8;
+        if ((psq >> 3) < 6 && push != wk && push != bk)
+        {
+          if (visit(kpk_index(KPK_BLACK, wk, bk, push)))
+            return KPK_WIN;
+          const int push2 = push + 8;
+          if ((psq >> 3) == 1 && push2 != wk && push2 != bk && visit(kpk_index(KPK_BLACK, wk, bk, push2)))
+            return KPK_WIN;
+        }
+        return unknown ? KPK_UNKNOWN : KPK_DRAW;
+      }
+
+      BB to = king_att(bk) & ~(king_att(wk) | chess::bb::white_pawn_attacks(bit(psq)) | bit(psq));
+      while (to)
+      {
+        const int s = chess::bb::ctz64(to);
+        to &= to - 1;
+        const std::uint8_t r = res[kpk_index(KPK_WHITE, wk, s, psq)];
+        if (r == KPK_DRAW)
+          return KPK_DRAW;
+        unknown |= r == KPK_UNKNOWN;
+      }
+      return unknown ? KPK_UNKNOWN : KPK_WIN;
+    }
+
+    void build_kpk()
+    {
+      std::vector<std::uint8_t> res(KPK_SIZE);
+      auto decode = [](int idx, int &stm, int &wk, int &bk, int &psq)
+      {
+        stm = idx & 1;
+        bk = (idx >> 1) & 63;
+        wk = (idx >> 7) & 63;
+        const int p = idx >> 13;
+        psq = (p / 4 + 1) * 8 + p % 4;
+      };
+
+      int stm, wk, bk, psq;
+      for (int i = 0; i < KPK_SIZE; ++i)
+      {
+        decode(i, stm, wk, bk, psq);
+        res[i] = kpk_initial(stm, wk, bk, psq);
+      }
+
+      for (bool changed = true; changed;)
+      {
+        changed = false;
+        for (int i = 0; i < KPK_SIZE; ++i)
+        {
+          if (res[i] != KPK_UNKNOWN)
+            continue;
+          decode(i, stm, wk, bk, psq);
+          const KpkResult r = kpk_step(res, stm, wk, bk, psq);
+          if (r != KPK_UNKNOWN)
+          {
+            res[i] = r;
+            changed = true;
+          }
+        }
+      }
+
+      // Whatever is still unknown cannot be forced: a draw.
+      for (int i = 0; i < KPK_SIZE; ++i)
+        if (res[i] == KPK_WIN)
+          g_kpkWin[i >> 5] |= 1u << (i & 31);
+    }
+
+    LILIA_ALWAYS_INLINE int king_sq(const chess::Board &b, chess::Color c) noexcept
+    {
+      return chess::bb::ctz64(b.getPieces(c, chess::PieceType::King));
+    }
+
+    LILIA_ALWAYS_INLINE int cheb(int a, int b) noexcept
+    {
+      return std::max(std::abs((a & 7) - (b & 7)), std::abs((a >> 3) - (b >> 3)));
+    }
+
+    LILIA_ALWAYS_INLINE int manhattan(int a, int b) noexcept
+    {
+      return std::abs((a & 7) - (b & 7)) + std::abs((a >> 3) - (b >> 3));
+    }
+
+    LILIA_ALWAYS_INLINE bool is_light(int sq) noexcept
+    {
+      return ((sq ^ (sq >> 3)) & 1) != 0;
+    }
+
+    // Side owning the pawns; scale functions are only called when exactly one side has any.
+    LILIA_ALWAYS_INLINE chess::Color pawn_side(const chess::Board &b) noexcept
+    {
+      return b.getPieces(chess::Color::White, chess::PieceType::Pawn) ? chess::Color::White
+                                                                       : chess::Color::Black;
+    }
+
+    // Squares as seen by strong: rank 8 is strong's promotion rank.
+    LILIA_ALWAYS_INLINE int relative(chess::Color strong, int sq) noexcept
+    {
+      return strong == chess::Color::White ? sq : (sq ^ 56);
+    }
+
+    int scale_krpkr(const chess::Board &b) noexcept
+    {
+      const chess::Color strong = pawn_side(b);
+      const int psq = relative(strong, chess::bb::ctz64(b.getPieces(strong, chess::PieceType::Pawn)));
+      const int sk = relative(strong, king_sq(b, strong));
+      const int wk = relative(strong, king_sq(b, ~strong));
+
+      // Rook pawns: the generic side-pawn rule knows them better.
+      if ((psq & 7) == 0 || (psq & 7) == 7)
+        return NO_SCALE;
+
+      // Defending king ahead of the pawn, attacking king not: the Philidor setup is reachable.
+      if (std::abs((wk & 7) - (psq & 7)) <= 1 && (wk >> 3) > (psq >> 3) && (sk >> 3) <= (psq >> 3))
+        return SCALE_VERY_DRAWISH;
+      return NO_SCALE;
+    }
+
+    int scale_kbpsk(const chess::Board &b) noexcept
+    {
+      const chess::Color strong = pawn_side(b);
+      const BB pawns = b.getPieces(strong, chess::PieceType::Pawn);
+      const bool fileA = (pawns & ~chess::bb::FILE_A) == 0;
+      const bool fileH = (pawns & ~chess::bb::FILE_H) == 0;
+      if (!fileA && !fileH)
+        return NO_SCALE;
+
+      const int promo = relative(strong, fileA ? 56 : 63);
+      const int bishop = chess::bb::ctz64(b.getPieces(strong, chess::PieceType::Bishop));
+      if (is_light(bishop) == is_light(promo))
+        return NO_SCALE;
+
+      return cheb(king_sq(b, ~strong), promo) <= 1 ? SCALE_DRAW : NO_SCALE;
+    }
+
+    int scale_kbpkb(const chess::Board &b) noexcept
+    {
+      const chess::Color strong = pawn_side(b);
+      const int sb = chess::bb::ctz64(b.getPieces(strong, chess::PieceType::Bishop));
+      const int wb = chess::bb::ctz64(b.getPieces(~strong, chess::PieceType::Bishop));
+      if (is_light(sb) == is_light(wb))
+        return NO_SCALE;
+
+      const int psq = chess::bb::ctz64(b.getPieces(strong, chess::PieceType::Pawn));
+      BB path = 0;
+      const int step = strong == chess::Color::White ? 8 : -8;
+      for (int s = psq + step; s >= 0 && s < 64; s += step)
+        path |= bit(s);
+
+      const BB blockers = bit(king_sq(b, ~strong)) | bit(wb) |
+                          chess::magic::sliding_attacks(chess::magic::Slider::Bishop,
+                                                        static_cast<chess::Square>(wb), b.getAllPieces());
+      return (path & blockers) ? SCALE_VERY_DRAWISH : NO_SCALE;
+    }
+  }
+
+  void init()
+  {
+    static std::once_flag once;
+    std::call_once(once, build_kpk);
+  }
+
+  bool kpk_win(const chess::Board &b, chess::Color stm) noexcept
+  {
+    const chess::Color strong = pawn_side(b);
+    int psq = relative(strong, chess::bb::ctz64(b.getPieces(strong, chess::PieceType::Pawn)));
+    int wk = relative(strong, king_sq(b, strong));
+    int bk = relative(strong, king_sq(b, ~strong));
+    if ((psq & 7) >= 4)
+    {
+      psq ^= 7;
+      wk ^= 7;
+      bk ^= 7;
+    }
+
+    const int idx = kpk_index(stm == strong ? KPK_WHITE : KPK_BLACK, wk, bk, psq);
+    return (g_kpkWin[idx >> 5] >> (idx & 31)) & 1u;
+  }
+
+  int evaluate(EvalFn f, const chess::Board &b, chess::Color stm, int base) noexcept
+  {
+    switch (f)
+    {
+    case EvalFn::Draw:
+      return 0;
+
+    case EvalFn::KPK:
+    {
+      if (!kpk_win(b, stm))
+        return 0;
+      const chess::Color strong = pawn_side(b);
+      const int psq = relative(strong, chess::bb::ctz64(b.getPieces(strong, chess::PieceType::Pawn)));
+      const int bonus = KPK_WIN_BONUS + KPK_RANK_BONUS * ((psq >> 3) - 1);
+      return base + (strong == chess::Color::White ? bonus : -bonus);
+    }
+
+    case EvalFn::KBNK:
+    {
+      const chess::Color strong =
+          b.getPieces(chess::Color::White, chess::PieceType::Bishop) ? chess::Color::White : chess::Color::Black;
+      const int bishop = chess::bb::ctz64(b.getPieces(strong, chess::PieceType::Bishop));
+      const int sk = king_sq(b, strong);
+      const int wk = king_sq(b, ~strong);
+
+      // Mate is only forced in a corner the bishop controls.
+      const int c1 = is_light(bishop) ? 56 : 0;
+      const int c2 = is_light(bishop) ? 7 : 63;
+      const int d = std::min(manhattan(wk, c1), manhattan(wk, c2));
+      const int bonus = KBNK_CORNER_BONUS * (14 - d) + KBNK_KING_BONUS * (7 - cheb(sk, wk));
+      return base + (strong == chess::Color::White ? bonus : -bonus);
+    }
+
+    default:
+      return base;
+    }
+  }
+
+  int scale(ScaleFn f, const chess::Board &b) noexcept
+  {
+    switch (f)
+    {
+    case ScaleFn::KRPKR:
+      return scale_krpkr(b);
+    case ScaleFn::KBPsK:
+      return scale_kbpsk(b);
+    case ScaleFn::KBPKB:
+      return scale_kbpkb(b);
+    default:
+      return NO_SCALE;
+    }
+  }
+
+}
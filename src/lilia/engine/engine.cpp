@@ -13,33 +13,39 @@
 #include "lilia/engine/search.hpp"
 #include "lilia/engine/search_position.hpp"
 #include "lilia/engine/thread_pool.hpp"
+#include "lilia/engine/time_manager.hpp"
 
 namespace lilia::engine
 {
 
+  namespace
+  {
+    int resolve_threads(int requested)
+    {
+      const unsigned hw = std::thread::hardware_concurrency();
+      const int logical = (hw > 0 ? static_cast<int>(hw) : 1);
+
+      if (requested <= 0)
+        return std::max(1, logical - 1); // auto
+      return std::clamp(requested, 1, logical);
+    }
+  }
+
   struct Engine::Impl
   {
     EngineConfig cfg;
     TT tt;
 
     std::unique_ptr<Search> search;
+    // Lazy SMP helpers (thread 1..n-1), kept across searches so their tables stay warm.
+    std::vector<std::unique_ptr<Search>> helpers;
 
     explicit Impl(const EngineConfig &c)
-        : cfg(c), tt(c.ttSizeMb)
+        : cfg(c), tt(c.ttSizeMb, c.ttPages, c.ttSharedName)
     {
-      const unsigned hw = std::thread::hardware_concurrency();
-      const int logical = (hw > 0 ? static_cast<int>(hw) : 1);
-
-      if (cfg.threads <= 0)
-      {
-        cfg.threads = std::max(1, logical - 1); // auto
-      }
-      else
-      {
-        cfg.threads = std::clamp(cfg.threads, 1, logical);
-      }
+      cfg.threads = resolve_threads(cfg.threads);
 
-      ThreadPool::instance(cfg.threads);
+      ThreadPool::instance(cfg.threads).set_pinning(cfg.pinThreads);
       search = std::make_unique<Search>(tt, cfg);
     }
   };
@@ -52,50 +58,36 @@ namespace lilia::engine
 
   Engine::~Engine()
   {
-    try
-    {
-      pimpl->tt.clear();
-    }
-    catch (...)
-    {
-    }
-
-    try
-    {
-      if (pimpl->search)
-        pimpl->search->clearSearchState();
-    }
-    catch (...)
-    {
-    }
-
+    // No TT or search-state clear here: zeroing tables that are about to be freed only
+    // delays quit and hash resizes.
     delete pimpl;
   }
 
   std::optional<chess::Move> Engine::find_best_move(chess::Position &pos,
                                                     int maxDepth,
-                                                    std::shared_ptr<std::atomic<bool>> stop)
+                                                    std::shared_ptr<std::atomic<bool>> stop,
+                                                    TimeManager *tm,
+                                                    const std::atomic<bool> *cancel)
   {
     if (maxDepth <= 0)
       maxDepth = pimpl->cfg.maxDepth;
 
-    try
-    {
-      pimpl->search->clearSearchState();
-    }
-    catch (...)
-    {
-    }
-
+    // Heuristics and TT survive between moves; they only decay (history) or
+    // age out (TT generation). newGame() is the explicit reset.
     SearchPosition spos(pos);
 
+    if (!stop)
+      stop = std::make_shared<std::atomic<bool>>(false);
+    pimpl->search->set_time_control(tm, cancel);
+
     try
     {
-      (void)pimpl->search->search_root_lazy_smp(spos, maxDepth, stop, pimpl->cfg.threads);
+      (void)pimpl->search->search_root_lazy_smp(spos, maxDepth, stop, pimpl->helpers, pimpl->cfg.threads);
     }
     catch (...)
     {
     }
+    pimpl->search->set_time_control(nullptr, nullptr);
 
     const auto &stats = pimpl->search->getStats();
     if (stats.bestMove.has_value())
@@ -124,21 +116,16 @@ namespace lilia::engine
     try
     {
       chess::MoveGenerator mg;
-      std::vector<chess::Move> pseudo;
-      pseudo.reserve(128);
-      mg.generatePseudoLegalMoves(pos.getBoard(), pos.getState(), pseudo);
+      std::vector<chess::Move> legal;
+      legal.reserve(128);
+      mg.generateLegalMoves(pos.getBoard(), pos.getState(), legal);
 
       std::optional<chess::Move> bestCapPromo;
       int bestCapScore = std::numeric_limits<int>::min();
       std::optional<chess::Move> firstLegal;
 
-      for (const auto &m : pseudo)
+      for (const auto &m : legal)
       {
-        chess::Position tmp = pos;
-        chess::StateInfo st{};
-        if (!tmp.doMove(m, st))
-          continue;
-
         if (m.isCapture() || m.promotion() != chess::PieceType::None)
         {
           const int sc = mvv_lva(pos, m);
@@ -176,4 +163,55 @@ namespace lilia::engine
     return pimpl->cfg;
   }
 
+  void Engine::setConfig(const EngineConfig &cfg)
+  {
+    const std::size_t oldHash = pimpl->cfg.ttSizeMb;
+    const TTPagePolicy oldPages = pimpl->cfg.ttPages;
+    const std::string oldShared = pimpl->cfg.ttSharedName;
+
+    // Search keeps a reference to pimpl->cfg, so assigning in place is enough.
+    pimpl->cfg = cfg;
+    pimpl->cfg.threads = resolve_threads(cfg.threads);
+    ThreadPool::instance().maybe_resize(pimpl->cfg.threads);
+    ThreadPool::instance().set_pinning(pimpl->cfg.pinThreads);
+
+    if (pimpl->cfg.ttSizeMb != oldHash || pimpl->cfg.ttPages != oldPages || pimpl->cfg.ttSharedName != oldShared)
+      pimpl->tt.resize(pimpl->cfg.ttSizeMb, pimpl->cfg.ttPages, pimpl->cfg.ttSharedName);
+  }
+
+  TTPageMode Engine::ttPageMode() const
+  {
+    return pimpl->tt.page_mode();
+  }
+
+  void Engine::setInfoCallback(std::function<void(const SearchInfo &)> cb)
+  {
+    pimpl->search->set_info_callback(std::move(cb));
+  }
+
+  bool Engine::saveHash(const std::string &path) const
+  {
+    return pimpl->tt.save(path);
+  }
+
+  bool Engine::loadHash(const std::string &path)
+  {
+    if (!pimpl->tt.load(path, pimpl->cfg.ttPages))
+      return false;
+    pimpl->cfg.ttSizeMb = pimpl->tt.size_mb();
+    return true;
+  }
+
+  void Engine::newGame()
+  {
+    // A shared table belongs to every attached process; only age it.
+    if (pimpl->tt.is_shared())
+      pimpl->tt.new_generation();
+    else
+      pimpl->tt.clear();
+    pimpl->search->clearSearchState();
+    for (auto &h : pimpl->helpers)
+      h->clearSearchState();
+  }
+
 }
@@ -7,11 +7,15 @@
 #include <cstdint>
 #include <limits>
 #include <cstdlib>
+#include <memory>
+#include <vector>
 
 #include "lilia/engine/config.hpp"
+#include "lilia/engine/endgame.hpp"
 #include "lilia/engine/eval_acc.hpp"
 #include "lilia/engine/eval_alias.hpp"
 #include "lilia/engine/eval_shared.hpp"
+#include "lilia/engine/nnue.hpp"
 #include "lilia/engine/search_position.hpp"
 #include "lilia/chess/core/bitboard.hpp"
 #include "lilia/chess/core/magic.hpp"
@@ -361,14 +365,19 @@ namespace lilia::engine
     int mg = 0, eg = 0;
     int lever = 0;
 
-    int wLightPawns = 0, wDarkPawns = 0;
-    int bLightPawns = 0, bDarkPawns = 0;
-    bool wClosedCenter = false, bClosedCenter = false;
-
     chess::bb::Bitboard wPass = 0, bPass = 0;
     chess::bb::Bitboard wHoles = 0, bHoles = 0;
   };
 
+  // Closed center: any direct white-vs-black pawn lock on the d/e files
+  LILIA_ALWAYS_INLINE bool center_locked(chess::bb::Bitboard wp, chess::bb::Bitboard bp) noexcept
+  {
+    constexpr chess::bb::Bitboard centralFiles = chess::bb::FILE_D | chess::bb::FILE_E;
+    return (chess::bb::north(wp & centralFiles) & (bp & centralFiles)) != 0ULL;
+  }
+
+  constexpr chess::bb::Bitboard LIGHT_SQUARES = 0x55AA55AA55AA55AAULL;
+
   static PawnOnly pawn_structure_pawnhash_only(chess::bb::Bitboard wp, chess::bb::Bitboard bp,
                                                chess::bb::Bitboard wPA, chess::bb::Bitboard bPA)
   {
@@ -378,11 +387,6 @@ namespace lilia::engine
 
     const chess::bb::Bitboard pawnOcc = wp | bp;
 
-    auto is_light_sq = [](int sq) -> bool
-    {
-      return ((sq ^ (sq >> 3)) & 1) != 0;
-    };
-
     chess::bb::Bitboard wFutureAtt = 0ULL;
     chess::bb::Bitboard bFutureAtt = 0ULL;
     int candidateDiff = 0; // white candidates - black candidates
@@ -440,11 +444,6 @@ namespace lilia::engine
       const int s = static_cast<int>(chess::bb::pop_lsb_unchecked(t));
       const int r = chess::bb::rank_of(static_cast<chess::Square>(s));
 
-      if (is_light_sq(s))
-        ++out.wLightPawns;
-      else
-        ++out.wDarkPawns;
-
       wFutureAtt |= M.wFuturePawnAtt[s];
 
       const bool passed = (M.wPassed[s] & bp) == 0ULL;
@@ -517,11 +516,6 @@ namespace lilia::engine
       const int s = static_cast<int>(chess::bb::pop_lsb_unchecked(t));
       const int r = chess::bb::rank_of(static_cast<chess::Square>(s));
 
-      if (is_light_sq(s))
-        ++out.bLightPawns;
-      else
-        ++out.bDarkPawns;
-
       bFutureAtt |= M.bFuturePawnAtt[s];
 
       const bool passed = (M.bPassed[s] & wp) == 0ULL;
@@ -590,15 +584,6 @@ namespace lilia::engine
     eg += (CANDIDATE_P * candidateDiff) / CANDIDATE_EG_DEN;
     eg -= (BACKWARD_P * backwardDiff) / BACKWARD_EG_DEN;
 
-    // Closed center: any direct white-vs-black pawn lock on the d/e files
-    const chess::bb::Bitboard centralFiles = chess::bb::FILE_D | chess::bb::FILE_E;
-    const chess::bb::Bitboard wCentral = wp & centralFiles;
-    const chess::bb::Bitboard bCentral = bp & centralFiles;
-
-    const bool centerLocked = (chess::bb::north(wCentral) & bCentral) != 0ULL;
-    out.wClosedCenter = centerLocked;
-    out.bClosedCenter = centerLocked;
-
     // Connected passers
     const int wC = chess::bb::popcount(((out.wPass & ~chess::bb::FILE_H) << 1) & out.wPass);
     const int bC = chess::bb::popcount(((out.bPass & ~chess::bb::FILE_H) << 1) & out.bPass);
@@ -1850,43 +1835,220 @@ namespace lilia::engine
   // =============================================================================
   // Eval caches
   // =============================================================================
-  constexpr size_t PAWN_BITS = 15;
-  constexpr size_t PAWN_SIZE = 1ULL << PAWN_BITS;
+  // Eval hash entry: the upper 48 key bits verify, the low 16 hold the score. Positions
+  // evaluated by NNUE are salted with the net generation, so the backends never share an
+  // entry and a newly loaded net never hits the previous net's scores.
+  constexpr uint64_t EVAL_HASH_KEY_MASK = ~0xFFFFULL;
+  constexpr uint64_t EVAL_HASH_NNUE_SALT = 0x9E3779B97F4A7C15ULL;
 
-  struct PawnEntry
+  LILIA_ALWAYS_INLINE uint64_t eval_hash_key(const SearchPosition &pos) noexcept
   {
-    uint64_t key = 0;
-    uint32_t generation = 0;
-    uint32_t _pad0 = 0;
-
-    int32_t mg = 0;
-    int32_t eg = 0;
-    int32_t lever = 0;
-
-    uint8_t wLightPawns = 0;
-    uint8_t wDarkPawns = 0;
-    uint8_t bLightPawns = 0;
-    uint8_t bDarkPawns = 0;
-    uint8_t wClosedCenter = 0;
-    uint8_t bClosedCenter = 0;
-    uint16_t _pad1 = 0;
+    if (!pos.nnueAcc())
+      return pos.hash();
+    return pos.hash() ^ (EVAL_HASH_NNUE_SALT * (2 * uint64_t(nnue::generation()) + 1));
+  }
 
-    uint64_t wPA = 0;
-    uint64_t bPA = 0;
+  // Lazy exit: bound on what mobility, king safety, threats and the other piece terms add
+  // to the cheap part of the score. Below LAZY_MIN_PHASE endgame scaling can move the
+  // score further than that, so low-material positions are always evaluated in full.
+  constexpr int LAZY_MARGIN = 350;
+  constexpr int LAZY_MIN_PHASE = 12;
+
+  // Pawn hash, split by access frequency. The hot part (32 bytes, two per cache line) is
+  // read on every probe; the cold part at the same index holds the hole maps, which only
+  // the outpost term needs. Everything else a pawn structure implies is cheaper to
+  // recompute than to load. Like the TT, entries are written without locks: each part is
+  // verified by check == key ^ (all its data words), so a torn write by another thread
+  // sharing the table reads as a miss. The salt keeps all-zero (empty) parts from
+  // verifying for the pawnless key 0.
+  constexpr uint64_t PAWN_HASH_SALT = 0xD6E8FEB86659FD93ULL;
+
+  struct PawnHot
+  {
+    uint64_t check = 0;
     uint64_t wPass = 0;
     uint64_t bPass = 0;
+    uint64_t packed = 0; // mg16 | eg16 << 16 | lever16 << 32
+  };
+  static_assert(sizeof(PawnHot) == 32);
+
+  struct PawnCold
+  {
+    uint64_t check = 0;
     uint64_t wHoles = 0;
     uint64_t bHoles = 0;
   };
 
+  class PawnHash
+  {
+  public:
+    explicit PawnHash(size_t mb) { resize(mb); }
+
+    size_t size_mb() const noexcept { return mb_; }
+
+    void resize(size_t mb)
+    {
+      mb_ = std::max<size_t>(mb, 1);
+      const size_t entries = std::bit_floor((mb_ << 20) / (sizeof(PawnHot) + sizeof(PawnCold)));
+      hot_.assign(entries, PawnHot{});
+      cold_.assign(entries, PawnCold{});
+    }
+
+    // Entries verify against key ^ salt_, so moving to a fresh salt drops them all in O(1).
+    void clear() noexcept { salt_ = PAWN_HASH_SALT ^ (++epoch_ * 0x9E3779B97F4A7C15ULL); }
+
+    void prefetch(uint64_t key) const noexcept { prefetch_ro(&hot_[index(key)]); }
+
+    bool probe(uint64_t key, PawnOnly &out) const noexcept
+    {
+      const PawnHot &e = hot_[index(key)];
+      const uint64_t wPass = e.wPass, bPass = e.bPass, packed = e.packed;
+      if ((e.check ^ wPass ^ bPass ^ packed) != (key ^ salt_))
+        return false;
+      out.wPass = wPass;
+      out.bPass = bPass;
+      out.mg = static_cast<int16_t>(packed);
+      out.eg = static_cast<int16_t>(packed >> 16);
+      out.lever = static_cast<int16_t>(packed >> 32);
+      return true;
+    }
+
+    bool probe_holes(uint64_t key, PawnOnly &out) const noexcept
+    {
+      const PawnCold &e = cold_[index(key)];
+      const uint64_t wHoles = e.wHoles, bHoles = e.bHoles;
+      if ((e.check ^ wHoles ^ bHoles) != (key ^ salt_))
+        return false;
+      out.wHoles = wHoles;
+      out.bHoles = bHoles;
+      return true;
+    }
+
+    void store(uint64_t key, const PawnOnly &po) noexcept
+    {
+      const size_t i = index(key);
+      const uint64_t packed = static_cast<uint16_t>(po.mg) |
+                              (static_cast<uint64_t>(static_cast<uint16_t>(po.eg)) << 16) |
+                              (static_cast<uint64_t>(static_cast<uint16_t>(po.lever)) << 32);
+      hot_[i] = PawnHot{key ^ salt_ ^ po.wPass ^ po.bPass ^ packed, po.wPass, po.bPass, packed};
+      cold_[i] = PawnCold{key ^ salt_ ^ po.wHoles ^ po.bHoles, po.wHoles, po.bHoles};
+    }
+
+  private:
+    size_t index(uint64_t key) const noexcept { return static_cast<size_t>(key) & (hot_.size() - 1); }
+
+    size_t mb_ = 0;
+    uint64_t salt_ = PAWN_HASH_SALT;
+    uint64_t epoch_ = 0;
+    std::vector<PawnHot> hot_;
+    std::vector<PawnCold> cold_;
+  };
+
+  // Material table: everything that depends on the piece counts alone, keyed by
+  // EvalAcc::matKey (exact, so a hit never needs verifying beyond the key). Entries hold
+  // the tuned material terms, so clearCaches() must run after the params change.
+  constexpr int MATERIAL_BITS = 13;
+
+  struct MaterialEntry
+  {
+    uint64_t key = ~0ULL;
+    int16_t bishopPair = 0;
+    int16_t imbalance = 0;
+    endgame::EvalFn evalFn = endgame::EvalFn::None;
+    endgame::ScaleFn scaleFn = endgame::ScaleFn::None;
+    bool genericScale = false; // endgame_scale() may return less than FULL_SCALE
+  };
+
+  LILIA_ALWAYS_INLINE size_t material_index(uint64_t key) noexcept
+  {
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> (64 - MATERIAL_BITS));
+  }
+
+  static void fill_material_entry(MaterialEntry &e, uint64_t key, const MaterialCounts &mc)
+  {
+    e.key = key;
+    e.bishopPair = static_cast<int16_t>(bishop_pair_term(mc));
+    e.imbalance = static_cast<int16_t>(material_imbalance(mc));
+    e.evalFn = endgame::EvalFn::None;
+    e.scaleFn = endgame::ScaleFn::None;
+
+    int pieces[2], minors[2];
+    for (int c = 0; c < 2; ++c)
+    {
+      minors[c] = mc.N[c] + mc.B[c];
+      pieces[c] = minors[c] + mc.R[c] + mc.Q[c];
+    }
+    const bool noPawns = (mc.P[0] | mc.P[1]) == 0;
+    const bool noHeavies = (mc.R[0] | mc.R[1] | mc.Q[0] | mc.Q[1]) == 0;
+    const bool rookEnding = mc.R[0] == 1 && mc.R[1] == 1 && minors[0] == 0 && minors[1] == 0 &&
+                            mc.Q[0] == 0 && mc.Q[1] == 0;
+
+    // Same predicate as the early returns of endgame_scale(): outside it the generic
+    // scaling is always FULL_SCALE and is skipped.
+    e.genericScale = (noPawns && noHeavies) || (rookEnding && noPawns);
+    for (int c = 0; c < 2; ++c)
+    {
+      const int o = 1 - c;
+      const bool oppBare = mc.P[o] == 0 && pieces[o] == 0;
+      if (mc.P[c] == 1 && minors[c] <= 1 && pieces[c] == minors[c] && oppBare)
+        e.genericScale = true;
+      if (rookEnding && mc.P[o] == 0 && mc.P[c] <= SIDEPAWN_ROOK_MAX_PAWNS)
+        e.genericScale = true;
+    }
+
+    // Dead draws: bare kings, a lone minor, KR vs KR.
+    if (noPawns && ((pieces[0] == 0 && pieces[1] <= 1 && noHeavies) ||
+                    (pieces[1] == 0 && pieces[0] <= 1 && noHeavies) || rookEnding))
+    {
+      e.evalFn = endgame::EvalFn::Draw;
+      return;
+    }
+
+    for (int c = 0; c < 2; ++c)
+    {
+      const int o = 1 - c;
+      const bool oppBare = mc.P[o] == 0 && pieces[o] == 0;
+      if (!oppBare)
+        continue;
+
+      if (mc.P[c] == 1 && pieces[c] == 0)
+        e.evalFn = endgame::EvalFn::KPK;
+      else if (mc.P[c] == 0 && mc.B[c] == 1 && mc.N[c] == 1 && pieces[c] == 2)
+        e.evalFn = endgame::EvalFn::KBNK;
+      else if (mc.P[c] >= 1 && mc.B[c] == 1 && pieces[c] == 1)
+        e.scaleFn = endgame::ScaleFn::KBPsK;
+      return;
+    }
+
+    for (int c = 0; c < 2; ++c)
+    {
+      const int o = 1 - c;
+      if (mc.P[c] != 1 || mc.P[o] != 0)
+        continue;
+      if (rookEnding)
+        e.scaleFn = endgame::ScaleFn::KRPKR;
+      else if (noHeavies && mc.B[c] == 1 && mc.B[o] == 1 && mc.N[c] == 0 && mc.N[o] == 0)
+        e.scaleFn = endgame::ScaleFn::KBPKB;
+    }
+  }
+
   struct Evaluator::Impl
   {
-    uint32_t pawnGeneration = 1;
-    std::array<PawnEntry, PAWN_SIZE> pawn{};
+    std::shared_ptr<PawnHash> pawn = std::make_shared<PawnHash>(EngineConfig{}.pawnHashMb);
+    bool pawnShared = false;
+
+    std::vector<MaterialEntry> material = std::vector<MaterialEntry>(size_t{1} << MATERIAL_BITS);
+
+    std::vector<uint64_t> evalHash; // power of two, empty when off
+    size_t evalHashMb = 0;
+    Evaluator::EvalHashStats evalHashStats{};
   };
 
   Evaluator::Evaluator() noexcept
   {
+    // The material table hands KPK to the bitbase; build it here too so an Evaluator
+    // works without Engine::init() (tests, tools).
+    endgame::init();
     m_impl = new Impl();
   }
   Evaluator::~Evaluator() noexcept
@@ -1899,22 +2061,61 @@ namespace lilia::engine
     if (!m_impl)
       return;
 
-    ++m_impl->pawnGeneration;
+    // A shared pawn table is cleared by its owner only.
+    if (!m_impl->pawnShared)
+      m_impl->pawn->clear();
+    std::fill(m_impl->material.begin(), m_impl->material.end(), MaterialEntry{});
+    std::fill(m_impl->evalHash.begin(), m_impl->evalHash.end(), 0);
+  }
+
+  void Evaluator::clearPawnHash() const noexcept
+  {
+    if (m_impl && !m_impl->pawnShared)
+      m_impl->pawn->clear();
+  }
 
-    if (m_impl->pawnGeneration == 0)
+  void Evaluator::setPawnHashSize(std::size_t mb)
+  {
+    if (m_impl->pawnShared)
     {
-      m_impl->pawnGeneration = 1;
-      for (auto &e : m_impl->pawn)
-      {
-        e.key = 0;
-        e.generation = 0;
-      }
+      m_impl->pawn = std::make_shared<PawnHash>(mb);
+      m_impl->pawnShared = false;
+    }
+    else if (m_impl->pawn->size_mb() != mb)
+    {
+      m_impl->pawn->resize(mb);
     }
   }
 
-  static LILIA_ALWAYS_INLINE size_t idx_pawn(uint64_t k)
+  void Evaluator::sharePawnHash(const Evaluator &owner)
+  {
+    m_impl->pawn = owner.m_impl->pawn;
+    m_impl->pawnShared = true;
+  }
+
+  void Evaluator::setEvalHashSize(std::size_t mb)
+  {
+    if (mb == m_impl->evalHashMb)
+      return;
+    m_impl->evalHashMb = mb;
+    m_impl->evalHash.clear();
+    if (mb == 0)
+    {
+      m_impl->evalHash.shrink_to_fit();
+      return;
+    }
+    const size_t entries = std::bit_floor((mb << 20) / sizeof(uint64_t));
+    m_impl->evalHash.assign(entries, 0);
+  }
+
+  Evaluator::EvalHashStats Evaluator::evalHashStats() const noexcept
+  {
+    return m_impl->evalHashStats;
+  }
+
+  void Evaluator::resetEvalHashStats() const noexcept
   {
-    return (size_t)k & (PAWN_SIZE - 1);
+    m_impl->evalHashStats = EvalHashStats{};
   }
 
   LILIA_ALWAYS_INLINE chess::bb::Bitboard rook_pins_from_kingray(chess::bb::Bitboard occ,
@@ -2127,11 +2328,47 @@ namespace lilia::engine
   // =============================================================================
   int Evaluator::evaluate(const SearchPosition &pos) const
   {
+    bool exact = true;
+    return evaluate(pos, -INF, INF, exact);
+  }
+
+  int Evaluator::evaluate(const SearchPosition &pos, int alpha, int beta, bool &exact) const
+  {
+    std::vector<uint64_t> &table = m_impl->evalHash;
+    if (table.empty())
+      return evaluateUncached(pos, alpha, beta, exact);
+
+    const uint64_t key = eval_hash_key(pos);
+    uint64_t &slot = table[key & (table.size() - 1)];
+    ++m_impl->evalHashStats.probes;
+    if (slot != 0 && ((slot ^ key) & EVAL_HASH_KEY_MASK) == 0)
+    {
+      ++m_impl->evalHashStats.hits;
+      exact = true;
+      return static_cast<int16_t>(slot & 0xFFFF);
+    }
+
+    const int v = evaluateUncached(pos, alpha, beta, exact);
+    if (exact) // lazy estimates are window-dependent, never cached
+      slot = (key & EVAL_HASH_KEY_MASK) | static_cast<uint16_t>(static_cast<int16_t>(v));
+    return v;
+  }
+
+  int Evaluator::evaluateUncached(const SearchPosition &pos, int alpha, int beta, bool &exact) const
+  {
+    exact = true;
+    if (const nnue::Accumulator *acc = pos.nnueAcc())
+    {
+      const chess::Color stm = pos.getState().sideToMove;
+      const int v = nnue::evaluate(*acc, stm);
+      return stm == chess::Color::White ? v : -v;
+    }
+
     const chess::Board &b = pos.getBoard();
     uint64_t pKey = (uint64_t)pos.getState().pawnKey;
 
-    const size_t pIdx = idx_pawn(pKey);
-    prefetch_ro(&m_impl->pawn[pIdx]);
+    PawnHash &pawnHash = *m_impl->pawn;
+    pawnHash.prefetch(pKey);
 
     std::array<chess::bb::Bitboard, 6> W{}, B{};
     for (int pt = 0; pt < 6; ++pt)
@@ -2169,93 +2406,61 @@ namespace lilia::engine
     const bool anyRooks = (mc.R[0] | mc.R[1]) != 0;
     const bool anyQueens = (mc.Q[0] | mc.Q[1]) != 0;
 
-    // Exact dead draw: KR vs KR
-    if (mc.P[0] == 0 && mc.P[1] == 0 &&
-        mc.N[0] == 0 && mc.N[1] == 0 &&
-        mc.B[0] == 0 && mc.B[1] == 0 &&
-        mc.Q[0] == 0 && mc.Q[1] == 0 &&
-        mc.R[0] == 1 && mc.R[1] == 1)
-      return 0;
+    // --- Material table: known endgames are scored by their own function ---
+    MaterialEntry &me = m_impl->material[material_index(ac.matKey)];
+    if (LILIA_UNLIKELY(me.key != ac.matKey))
+      fill_material_entry(me, ac.matKey, mc);
+    if (LILIA_UNLIKELY(me.evalFn != endgame::EvalFn::None))
+      return clampi(endgame::evaluate(me.evalFn, b, pos.getState().sideToMove, taper(mg, eg, curPhase)),
+                    -MATE + 1, MATE - 1);
+
+    // --- Pawn hash: pawn-only structure + passers, hole maps on demand ---
+    const chess::bb::Bitboard wPA = chess::bb::white_pawn_attacks(W[0]);
+    const chess::bb::Bitboard bPA = chess::bb::black_pawn_attacks(B[0]);
+
+    PawnOnly po{};
+    bool haveHoles = false;
+    if (!pawnHash.probe(pKey, po))
+    {
+      po = pawn_structure_pawnhash_only(W[0], B[0], wPA, bPA);
+      pawnHash.store(pKey, po);
+      haveHoles = true;
+    }
+    if (anyKnights && !haveHoles && !pawnHash.probe_holes(pKey, po))
+      po = pawn_structure_pawnhash_only(W[0], B[0], wPA, bPA);
 
-    // --- Pawn hash: pawn-only structure + cached PA / passers ---
-    int pMG = 0, pEG = 0;
-    int lever = 0;
-    chess::bb::Bitboard wPA = 0, bPA = 0, wPass = 0, bPass = 0;
-    chess::bb::Bitboard wHoles = 0, bHoles = 0;
+    const int pMG = po.mg, pEG = po.eg;
+    const int lever = po.lever;
+    const chess::bb::Bitboard wPass = po.wPass, bPass = po.bPass;
+    const chess::bb::Bitboard wHoles = po.wHoles, bHoles = po.bHoles;
+
+    const int wLightPawns = chess::bb::popcount(W[0] & LIGHT_SQUARES);
+    const int wDarkPawns = chess::bb::popcount(W[0] & ~LIGHT_SQUARES);
+    const int bLightPawns = chess::bb::popcount(B[0] & LIGHT_SQUARES);
+    const int bDarkPawns = chess::bb::popcount(B[0] & ~LIGHT_SQUARES);
+    const bool wClosedCenter = center_locked(W[0], B[0]);
+    const bool bClosedCenter = wClosedCenter;
 
-    int wLightPawns = 0, wDarkPawns = 0;
-    int bLightPawns = 0, bDarkPawns = 0;
-    bool wClosedCenter = false, bClosedCenter = false;
     const bool openingish = curPhase >= OPENING_PHASE_MIN;
     const int wMinorCnt = mc.N[0] + mc.B[0];
     const int bMinorCnt = mc.N[1] + mc.B[1];
 
-    {
-      PawnEntry &ps = m_impl->pawn[pIdx];
-      const uint32_t gen = m_impl->pawnGeneration;
+    // material-only terms and tempo: as cheap as the pawn hash
+    int bp = me.bishopPair;
+    int imb = me.imbalance;
 
-      if (ps.key == pKey && ps.generation == gen)
-      {
-        pMG = ps.mg;
-        pEG = ps.eg;
-        lever = ps.lever;
-
-        wPA = static_cast<chess::bb::Bitboard>(ps.wPA);
-        bPA = static_cast<chess::bb::Bitboard>(ps.bPA);
-        wPass = static_cast<chess::bb::Bitboard>(ps.wPass);
-        bPass = static_cast<chess::bb::Bitboard>(ps.bPass);
-        wHoles = static_cast<chess::bb::Bitboard>(ps.wHoles);
-        bHoles = static_cast<chess::bb::Bitboard>(ps.bHoles);
-
-        wLightPawns = ps.wLightPawns;
-        wDarkPawns = ps.wDarkPawns;
-        bLightPawns = ps.bLightPawns;
-        bDarkPawns = ps.bDarkPawns;
-        wClosedCenter = ps.wClosedCenter != 0;
-        bClosedCenter = ps.bClosedCenter != 0;
-      }
-      else
+    const bool wtm = (pos.getState().sideToMove == chess::Color::White);
+    const int tempo = taper(TEMPO_MG, TEMPO_EG, curPhase);
+
+    if (curPhase >= LAZY_MIN_PHASE)
+    {
+      const int lazyMG = mg + pMG + lever + bp + imb;
+      const int lazyEG = eg + pEG + lever / LEVER_EG_DEN + bp / BISHOP_PAIR_EG_DEN + imb / IMBALANCE_EG_DEN;
+      const int lazy = taper(lazyMG, lazyEG, curPhase) + (wtm ? +tempo : -tempo);
+      if (lazy + LAZY_MARGIN <= alpha || lazy - LAZY_MARGIN >= beta)
       {
-        wPA = chess::bb::white_pawn_attacks(W[0]);
-        bPA = chess::bb::black_pawn_attacks(B[0]);
-
-        const PawnOnly po = pawn_structure_pawnhash_only(W[0], B[0], wPA, bPA);
-
-        pMG = po.mg;
-        pEG = po.eg;
-        lever = po.lever;
-        wPass = po.wPass;
-        bPass = po.bPass;
-        wHoles = po.wHoles;
-        bHoles = po.bHoles;
-
-        wLightPawns = po.wLightPawns;
-        wDarkPawns = po.wDarkPawns;
-        bLightPawns = po.bLightPawns;
-        bDarkPawns = po.bDarkPawns;
-        wClosedCenter = po.wClosedCenter;
-        bClosedCenter = po.bClosedCenter;
-
-        ps.key = pKey;
-        ps.generation = gen;
-
-        ps.mg = pMG;
-        ps.eg = pEG;
-        ps.lever = lever;
-
-        ps.wPA = static_cast<uint64_t>(wPA);
-        ps.bPA = static_cast<uint64_t>(bPA);
-        ps.wPass = static_cast<uint64_t>(wPass);
-        ps.bPass = static_cast<uint64_t>(bPass);
-        ps.wHoles = static_cast<uint64_t>(wHoles);
-        ps.bHoles = static_cast<uint64_t>(bHoles);
-
-        ps.wLightPawns = static_cast<uint8_t>(wLightPawns);
-        ps.wDarkPawns = static_cast<uint8_t>(wDarkPawns);
-        ps.bLightPawns = static_cast<uint8_t>(bLightPawns);
-        ps.bDarkPawns = static_cast<uint8_t>(bDarkPawns);
-        ps.wClosedCenter = static_cast<uint8_t>(wClosedCenter);
-        ps.bClosedCenter = static_cast<uint8_t>(bClosedCenter);
+        exact = false;
+        return clampi(lazy, -MATE + 1, MATE - 1);
       }
     }
 
@@ -2293,7 +2498,6 @@ namespace lilia::engine
     int kDanger = king_attack_danger(occ, wocc, bocc, W, B, A, wK, bK);
 
     // style & structure
-    int bp = bishop_pair_term(mc);
     int badB = anyBishops
                    ? bad_bishop(W, B,
                                 wLightPawns, wDarkPawns,
@@ -2306,9 +2510,6 @@ namespace lilia::engine
                   ? space_term(wocc, bocc, wPA, bPA, wMinorCnt, bMinorCnt)
                   : 0;
 
-    // material imbalance
-    int imb = material_imbalance(mc);
-
     // KS mixing
     const int ksMulMG = queensOn ? KS_MIX_MG_Q_ON : KS_MIX_MG_Q_OFF;
     int ksMG = kDanger * ksMulMG / 100;
@@ -2375,14 +2576,14 @@ namespace lilia::engine
     // scale only the EG component
     eg += initiative_complexity(mc, W[0], B[0], wPass, bPass, eg);
 
-    const int scale = endgame_scale(W, B, mc, wK, bK);
+    int scale = me.scaleFn != endgame::ScaleFn::None ? endgame::scale(me.scaleFn, b) : endgame::NO_SCALE;
+    if (scale == endgame::NO_SCALE)
+      scale = me.genericScale ? endgame_scale(W, B, mc, wK, bK) : FULL_SCALE;
     eg = (eg * scale) / FULL_SCALE;
 
     int score = taper(mg, eg, curPhase);
 
     // tempo (phase-aware)
-    const bool wtm = (pos.getState().sideToMove == chess::Color::White);
-    const int tempo = taper(TEMPO_MG, TEMPO_EG, curPhase);
     score += (wtm ? +tempo : -tempo);
 
     score = clampi(score, -MATE + 1, MATE - 1);
@@ -0,0 +1,125 @@
+#include "lilia/engine/move_order.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "lilia/chess/core/piece_encoding.hpp"
+
+namespace lilia::engine
+{
+  namespace
+  {
+    constexpr int PT_NB = chess::PIECE_TYPE_NB;
+
+    static_assert(sizeof(chess::Move) == 4, "moves are loaded eight to a vector");
+
+    // Stands in for a missing continuation slice (+2 for the 32-bit gather).
+    alignas(64) constexpr std::int16_t NO_CONTINUATION[PT_NB * chess::SQ_NB + 2] = {};
+
+    struct Indices
+    {
+      int fromTo;
+      int pieceTo;
+      int capture; // -1 for non-captures
+    };
+
+    LILIA_ALWAYS_INLINE Indices indices(const chess::Board &b, chess::Move m) noexcept
+    {
+      const int from = m.from();
+      const int to = m.to();
+      int mover = chess::decode_ti(b.getPiecePacked(m.from()));
+      if (mover < 0)
+        mover = 0;
+
+      int capture = -1;
+      if (m.isCapture())
+      {
+        int victim = m.isEnPassant() ? 0 : chess::decode_ti(b.getPiecePacked(m.to()));
+        if (victim < 0)
+          victim = 0;
+        capture = (mover * chess::SQ_NB + to) * PT_NB + victim;
+      }
+      return {from * chess::SQ_NB + to, mover * chess::SQ_NB + to, capture};
+    }
+
+    LILIA_ALWAYS_INLINE int score_scalar(const OrderHistory &h, const std::int16_t *const cont[3],
+                                         const Indices &ix) noexcept
+    {
+      if (ix.capture >= 0)
+        return h.capture[ix.capture];
+      return h.fromTo[ix.fromTo] + (h.pieceTo[ix.pieceTo] >> h.pieceToShift) + cont[0][ix.pieceTo] +
+             (cont[1][ix.pieceTo] >> 1) + (cont[2][ix.pieceTo] >> 1);
+    }
+
+#if defined(__AVX2__)
+    // Sign-extended int16 at base[idx] for the lanes in mask, 0 elsewhere.
+    LILIA_ALWAYS_INLINE __m256i gather_i16(const std::int16_t *base, __m256i idx, __m256i mask) noexcept
+    {
+      const __m256i v = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(),
+                                                    reinterpret_cast<const int *>(base), idx, mask, 2);
+      return _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+    }
+#endif
+  }
+
+  void history_scores(const OrderHistory &h, const chess::Board &b, const chess::Move *moves,
+                      int n, int *out) noexcept
+  {
+    const std::int16_t *const cont[3] = {h.cont[0] ? h.cont[0] : NO_CONTINUATION,
+                                         h.cont[1] ? h.cont[1] : NO_CONTINUATION,
+                                         h.cont[2] ? h.cont[2] : NO_CONTINUATION};
+    int i = 0;
+
+#if defined(__AVX2__)
+    const __m128i shift = _mm_cvtsi32_si128(h.pieceToShift);
+    const __m256i sqMask = _mm256_set1_epi32(0x3F);
+    const __m256i capFlag = _mm256_set1_epi32(static_cast<int>(chess::Move::CAP_MASK));
+    const __m256i epFlag = _mm256_set1_epi32(static_cast<int>(chess::Move::EP_MASK));
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i allOnes = _mm256_set1_epi32(-1);
+    const auto *mailbox = reinterpret_cast<const int *>(b.packedSquares());
+
+    // Type index on the given squares (pawn for empty ones), from aligned dword gathers
+    // of the byte mailbox.
+    auto type_at = [&](__m256i sq, __m256i mask)
+    {
+      const __m256i dw = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), mailbox,
+                                                     _mm256_srli_epi32(sq, 2), mask, 4);
+      const __m256i byteShift = _mm256_slli_epi32(_mm256_and_si256(sq, _mm256_set1_epi32(3)), 3);
+      const __m256i byte = _mm256_srlv_epi32(dw, byteShift);
+      const __m256i ti = _mm256_sub_epi32(_mm256_and_si256(byte, _mm256_set1_epi32(7)), one);
+      return _mm256_and_si256(_mm256_max_epi32(ti, _mm256_setzero_si256()), mask);
+    };
+
+    for (; i + 8 <= n; i += 8)
+    {
+      const __m256i mv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(moves + i));
+      const __m256i from = _mm256_and_si256(mv, sqMask);
+      const __m256i to = _mm256_and_si256(_mm256_srli_epi32(mv, chess::Move::TO_SHIFT), sqMask);
+      const __m256i isCap = _mm256_cmpeq_epi32(_mm256_and_si256(mv, capFlag), capFlag);
+      const __m256i isQuiet = _mm256_xor_si256(isCap, allOnes);
+      const __m256i isEp = _mm256_cmpeq_epi32(_mm256_and_si256(mv, epFlag), epFlag);
+
+      const __m256i mover = type_at(from, allOnes);
+      const __m256i victim = type_at(to, _mm256_andnot_si256(isEp, isCap)); // en passant: pawn
+      const __m256i vft = _mm256_or_si256(_mm256_slli_epi32(from, 6), to);
+      const __m256i vpt = _mm256_or_si256(_mm256_slli_epi32(mover, 6), to);
+      const __m256i vcap = _mm256_add_epi32(_mm256_mullo_epi32(vpt, _mm256_set1_epi32(PT_NB)), victim);
+
+      __m256i sum = gather_i16(h.fromTo, vft, isQuiet);
+      sum = _mm256_add_epi32(sum, _mm256_sra_epi32(gather_i16(h.pieceTo, vpt, isQuiet), shift));
+      sum = _mm256_add_epi32(sum, gather_i16(cont[0], vpt, isQuiet));
+      sum = _mm256_add_epi32(sum, _mm256_srai_epi32(gather_i16(cont[1], vpt, isQuiet), 1));
+      sum = _mm256_add_epi32(sum, _mm256_srai_epi32(gather_i16(cont[2], vpt, isQuiet), 1));
+      sum = _mm256_add_epi32(sum, gather_i16(h.capture, vcap, isCap));
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), sum);
+    }
+#endif
+
+    for (; i < n; ++i)
+      out[i] = score_scalar(h, cont, indices(b, moves[i]));
+  }
+
+}
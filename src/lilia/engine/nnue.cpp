@@ -0,0 +1,294 @@
+#include "lilia/engine/nnue.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+#include "lilia/chess/core/bitboard.hpp"
+
+namespace lilia::engine::nnue
+{
+  namespace
+  {
+    // Net file, little endian:
+    //   NetFileHeader
+    //   int16 ftBias[L1], int16 ftWeight[INPUTS][L1]
+    //   int32 b1[L2], int8 w1[L2][2 * L1]   (input: side to move's half first)
+    //   int32 b2[L3], int8 w2[L3][L2]
+    //   int32 b3,     int8 w3[L3]
+    // Hidden layers are clipped to [0, 127] after >> WEIGHT_SHIFT; the output is
+    // divided by OUTPUT_SCALE to give centipawns.
+    constexpr char NET_FILE_MAGIC[8] = {'L', 'I', 'L', 'N', 'N', 'U', 'E', '1'};
+    constexpr std::uint32_t NET_FILE_VERSION = 1;
+    constexpr std::uint32_t FEATURES_HALFKP = 1;
+
+    constexpr int WEIGHT_SHIFT = 6;
+    constexpr int OUTPUT_SCALE = 16;
+
+    struct NetFileHeader
+    {
+      char magic[8];
+      std::uint32_t version;
+      std::uint32_t features;
+      std::uint32_t l1, l2, l3;
+    };
+    static_assert(sizeof(NetFileHeader) == 28);
+
+    struct Network
+    {
+      alignas(64) std::int16_t ftBias[L1];
+      std::vector<std::int16_t> ftWeight; // [INPUTS][L1]
+      alignas(64) std::int32_t b1[L2];
+      alignas(64) std::int8_t w1[L2][2 * L1];
+      alignas(64) std::int32_t b2[L3];
+      alignas(64) std::int8_t w2[L3][L2];
+      alignas(64) std::int8_t w3[L3];
+      std::int32_t b3;
+    };
+
+    std::unique_ptr<Network> g_net;
+    std::string g_path;
+    std::uint32_t g_generation = 0;
+    bool g_enabled = true;
+
+    LILIA_ALWAYS_INLINE int orient(chess::Color persp, int sq) noexcept
+    {
+      return persp == chess::Color::White ? sq : (sq ^ 56);
+    }
+
+    LILIA_ALWAYS_INLINE int feature(chess::Color persp, int ksq, chess::Color c, chess::PieceType pt,
+                                    int sq) noexcept
+    {
+      const int piece = static_cast<int>(pt) * 2 + (c != persp ? 1 : 0);
+      return (ksq * 10 + piece) * chess::SQ_NB + orient(persp, sq);
+    }
+
+    LILIA_ALWAYS_INLINE int king_square(const chess::Board &b, chess::Color c) noexcept
+    {
+      const chess::bb::Bitboard k = b.getPieces(c, chess::PieceType::King);
+      return k ? chess::bb::ctz64(k) : 0;
+    }
+
+    void refresh_perspective(std::int16_t *out, const chess::Board &b, chess::Color persp) noexcept
+    {
+      const Network &net = *g_net;
+      const int ksq = orient(persp, king_square(b, persp));
+      std::memcpy(out, net.ftBias, sizeof(net.ftBias));
+
+      for (chess::Color c : {chess::Color::White, chess::Color::Black})
+        for (int pt = 0; pt < static_cast<int>(chess::PieceType::King); ++pt)
+        {
+          chess::bb::Bitboard pcs = b.getPieces(c, static_cast<chess::PieceType>(pt));
+          while (pcs)
+          {
+            const int sq = chess::bb::ctz64(pcs);
+            pcs &= pcs - 1;
+            const std::int16_t *w =
+                &net.ftWeight[std::size_t(feature(persp, ksq, c, static_cast<chess::PieceType>(pt), sq)) * L1];
+            for (int i = 0; i < L1; ++i)
+              out[i] = static_cast<std::int16_t>(out[i] + w[i]);
+          }
+        }
+    }
+
+    // Sum of in[i] * w[i] for n a multiple of 32; in is in [0, 127], so the pairwise
+    // int16 sums of maddubs cannot saturate.
+    LILIA_ALWAYS_INLINE std::int32_t dot(const std::uint8_t *in, const std::int8_t *w, int n) noexcept
+    {
+#if defined(__AVX2__)
+      __m256i acc = _mm256_setzero_si256();
+      const __m256i ones = _mm256_set1_epi16(1);
+      for (int i = 0; i < n; i += 32)
+      {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(w + i));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(x, y), ones));
+      }
+      __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+      s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+      s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+      return _mm_cvtsi128_si32(s);
+#elif defined(__SSSE3__)
+      __m128i acc = _mm_setzero_si128();
+      const __m128i ones = _mm_set1_epi16(1);
+      for (int i = 0; i < n; i += 16)
+      {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(w + i));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_maddubs_epi16(x, y), ones));
+      }
+      acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+      acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+      return _mm_cvtsi128_si32(acc);
+#else
+      std::int32_t sum = 0;
+      for (int i = 0; i < n; ++i)
+        sum += static_cast<std::int32_t>(in[i]) * w[i];
+      return sum;
+#endif
+    }
+
+    template <int IN, int OUT>
+    LILIA_ALWAYS_INLINE void affine_crelu(const std::uint8_t *in, const std::int8_t (*w)[IN],
+                                          const std::int32_t *b, std::uint8_t *out) noexcept
+    {
+      for (int o = 0; o < OUT; ++o)
+        out[o] = static_cast<std::uint8_t>(std::clamp((b[o] + dot(in, w[o], IN)) >> WEIGHT_SHIFT, 0, 127));
+    }
+
+    bool read_exact(std::ifstream &in, void *dst, std::size_t bytes)
+    {
+      in.read(static_cast<char *>(dst), static_cast<std::streamsize>(bytes));
+      return static_cast<std::size_t>(in.gcount()) == bytes;
+    }
+  }
+
+  bool load(const std::string &path, std::string &err)
+  {
+    static_assert(std::endian::native == std::endian::little, "net files are little endian");
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+      err = "cannot open " + path;
+      return false;
+    }
+
+    NetFileHeader h{};
+    if (!read_exact(in, &h, sizeof(h)) || std::memcmp(h.magic, NET_FILE_MAGIC, sizeof(h.magic)) != 0)
+    {
+      err = path + " is not a lilia net";
+      return false;
+    }
+    if (h.version != NET_FILE_VERSION || h.features != FEATURES_HALFKP || h.l1 != L1 || h.l2 != L2 ||
+        h.l3 != L3)
+    {
+      err = path + " has an unsupported architecture";
+      return false;
+    }
+
+    auto net = std::make_unique<Network>();
+    net->ftWeight.resize(std::size_t(INPUTS) * L1);
+    const bool ok = read_exact(in, net->ftBias, sizeof(net->ftBias)) &&
+                    read_exact(in, net->ftWeight.data(), net->ftWeight.size() * sizeof(std::int16_t)) &&
+                    read_exact(in, net->b1, sizeof(net->b1)) && read_exact(in, net->w1, sizeof(net->w1)) &&
+                    read_exact(in, net->b2, sizeof(net->b2)) && read_exact(in, net->w2, sizeof(net->w2)) &&
+                    read_exact(in, &net->b3, sizeof(net->b3)) && read_exact(in, net->w3, sizeof(net->w3));
+    if (!ok || in.peek() != std::ifstream::traits_type::eof())
+    {
+      err = path + " has the wrong size";
+      return false;
+    }
+
+    g_net = std::move(net);
+    g_path = path;
+    ++g_generation;
+    return true;
+  }
+
+  void unload() noexcept
+  {
+    if (g_net)
+      ++g_generation;
+    g_net.reset();
+    g_path.clear();
+  }
+
+  bool loaded() noexcept { return g_net != nullptr; }
+  const std::string &loaded_path() noexcept { return g_path; }
+  std::uint32_t generation() noexcept { return g_generation; }
+
+  void set_enabled(bool on) noexcept { g_enabled = on; }
+  bool enabled() noexcept { return g_enabled; }
+  bool active() noexcept { return g_enabled && g_net; }
+
+  void refresh(Accumulator &acc, const chess::Board &b) noexcept
+  {
+    refresh_perspective(acc.v[0], b, chess::Color::White);
+    refresh_perspective(acc.v[1], b, chess::Color::Black);
+  }
+
+  void update(Accumulator &acc, const Accumulator &prev, const chess::StateInfo &st,
+              const chess::Board &b) noexcept
+  {
+    const Network &net = *g_net;
+    const chess::Color us = st.moved.color;
+    const chess::Color them = ~us;
+    const chess::Move &m = st.move;
+
+    for (chess::Color persp : {chess::Color::White, chess::Color::Black})
+    {
+      std::int16_t *out = acc.v[chess::bb::ci(persp)];
+
+      // Own king moved: every feature of this half changes.
+      if (persp == us && st.moved.type == chess::PieceType::King)
+      {
+        refresh_perspective(out, b, persp);
+        continue;
+      }
+
+      const int ksq = orient(persp, king_square(b, persp));
+      int added[2], removed[2];
+      int nAdd = 0, nRem = 0;
+
+      if (st.isPromotion())
+      {
+        removed[nRem++] = feature(persp, ksq, us, chess::PieceType::Pawn, m.from());
+        added[nAdd++] = feature(persp, ksq, us, m.promotion(), m.to());
+      }
+      else if (st.moved.type != chess::PieceType::King)
+      {
+        removed[nRem++] = feature(persp, ksq, us, st.moved.type, m.from());
+        added[nAdd++] = feature(persp, ksq, us, st.moved.type, m.to());
+      }
+      if (st.isCapture())
+        removed[nRem++] = feature(persp, ksq, them, st.captured.type, st.capturedSquare);
+      if (st.isCastle())
+      {
+        removed[nRem++] = feature(persp, ksq, us, chess::PieceType::Rook, st.rookFrom);
+        added[nAdd++] = feature(persp, ksq, us, chess::PieceType::Rook, st.rookTo);
+      }
+
+      const std::int16_t *in = prev.v[chess::bb::ci(persp)];
+      std::memcpy(out, in, sizeof(acc.v[0]));
+      for (int k = 0; k < nRem; ++k)
+      {
+        const std::int16_t *w = &net.ftWeight[std::size_t(removed[k]) * L1];
+        for (int i = 0; i < L1; ++i)
+          out[i] = static_cast<std::int16_t>(out[i] - w[i]);
+      }
+      for (int k = 0; k < nAdd; ++k)
+      {
+        const std::int16_t *w = &net.ftWeight[std::size_t(added[k]) * L1];
+        for (int i = 0; i < L1; ++i)
+          out[i] = static_cast<std::int16_t>(out[i] + w[i]);
+      }
+    }
+  }
+
+  int evaluate(const Accumulator &acc, chess::Color stm) noexcept
+  {
+    const Network &net = *g_net;
+
+    alignas(64) std::uint8_t x0[2 * L1];
+    const std::int16_t *halves[2] = {acc.v[chess::bb::ci(stm)], acc.v[chess::bb::ci(~stm)]};
+    for (int h = 0; h < 2; ++h)
+      for (int i = 0; i < L1; ++i)
+        x0[h * L1 + i] = static_cast<std::uint8_t>(std::clamp<int>(halves[h][i], 0, 127));
+
+    alignas(64) std::uint8_t x1[L2];
+    alignas(64) std::uint8_t x2[L3];
+    affine_crelu<2 * L1, L2>(x0, net.w1, net.b1, x1);
+    affine_crelu<L2, L3>(x1, net.w2, net.b2, x2);
+
+    return (net.b3 + dot(x2, net.w3, L3)) / OUTPUT_SCALE;
+  }
+
+}
@@ -0,0 +1,245 @@
+#include "lilia/engine/perft.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "lilia/chess/chess_game.hpp"
+#include "lilia/chess/move_buffer.hpp"
+#include "lilia/chess/move_generator.hpp"
+#include "lilia/engine/thread_pool.hpp"
+
+namespace lilia::engine
+{
+
+  namespace
+  {
+    using steady_clock = std::chrono::steady_clock;
+
+    constexpr int MAX_PERFT_DEPTH = 32;
+    // Depths below this are cheaper to recount than to look up.
+    constexpr int PERFT_HASH_MIN_DEPTH = 2;
+
+    constexpr PerftCase SUITE[] = {
+        {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5,
+         {0, 20, 400, 8902, 197281, 4865609, 119060324}},
+        {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4,
+         {0, 48, 2039, 97862, 4085603, 193690690, 8031647685ULL}},
+        {"cpw3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6,
+         {0, 14, 191, 2812, 43238, 674624, 11030083}},
+        {"cpw4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5,
+         {0, 6, 264, 9467, 422333, 15833292, 706045033}},
+        {"cpw4-mirror", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1", 5,
+         {0, 6, 264, 9467, 422333, 15833292, 706045033}},
+        {"cpw5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4,
+         {0, 44, 1486, 62379, 2103487, 89941194, 0}},
+        {"cpw6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4,
+         {0, 46, 2079, 89890, 3894594, 164075551, 6923051137ULL}},
+    };
+
+    // Lock-free always-replace table: an entry is valid when check ^ data == key, so a torn
+    // write from another thread reads as a miss.
+    class PerftHash
+    {
+    public:
+      explicit PerftHash(std::size_t mb)
+      {
+        if (mb == 0)
+          return;
+        std::size_t n = 1;
+        while (n * 2 * sizeof(Entry) <= mb * 1024 * 1024)
+          n *= 2;
+        table_ = std::make_unique<Entry[]>(n);
+        mask_ = n - 1;
+      }
+
+      bool enabled() const noexcept { return table_ != nullptr; }
+
+      bool probe(std::uint64_t key, int depth, std::uint64_t &nodes) const noexcept
+      {
+        const Entry &e = table_[key & mask_];
+        const std::uint64_t data = e.data.load(std::memory_order_relaxed);
+        const std::uint64_t check = e.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != key || static_cast<int>(data & 0xFF) != depth)
+          return false;
+        nodes = data >> 8;
+        return true;
+      }
+
+      void store(std::uint64_t key, int depth, std::uint64_t nodes) noexcept
+      {
+        Entry &e = table_[key & mask_];
+        const std::uint64_t data = (nodes << 8) | static_cast<std::uint64_t>(depth);
+        e.check.store(key ^ data, std::memory_order_relaxed);
+        e.data.store(data, std::memory_order_relaxed);
+      }
+
+    private:
+      struct Entry
+      {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> data{0};
+      };
+
+      std::unique_ptr<Entry[]> table_;
+      std::size_t mask_ = 0;
+    };
+
+    struct PerftWalker
+    {
+      chess::Position pos;
+      chess::MoveGenerator mg;
+      PerftHash *hash = nullptr;
+      bool bulk = true;
+      const std::atomic<bool> *stop = nullptr;
+
+      std::array<chess::StateInfo, MAX_PERFT_DEPTH> st{};
+      std::array<std::array<chess::Move, chess::MAX_MOVES>, MAX_PERFT_DEPTH> moves{};
+
+      PerftWalker(const chess::Position &p, PerftHash *h, const PerftOptions &opt)
+          : pos(p), hash(h), bulk(opt.bulk), stop(opt.stop) {}
+
+      LILIA_ALWAYS_INLINE bool stopped() const noexcept
+      {
+        return stop && stop->load(std::memory_order_relaxed);
+      }
+
+      std::uint64_t run(int depth, int ply)
+      {
+        if (depth <= 0)
+          return 1;
+        if (depth >= 2 && stopped())
+          return 0;
+
+        chess::MoveBuffer buf(moves[ply].data(), chess::MAX_MOVES);
+        const int n = mg.generateLegalMoves(pos.getBoard(), pos.getState(), buf);
+        if (depth == 1 && bulk)
+          return static_cast<std::uint64_t>(n);
+
+        const std::uint64_t key = pos.hash();
+        const bool useHash = hash && depth >= PERFT_HASH_MIN_DEPTH;
+        std::uint64_t nodes = 0;
+        if (useHash && hash->probe(key, depth, nodes))
+          return nodes;
+
+        for (int i = 0; i < n; ++i)
+        {
+          pos.doLegalMove(moves[ply][i], st[ply]);
+          nodes += run(depth - 1, ply + 1);
+          pos.undoMove();
+        }
+
+        if (useHash && !stopped())
+          hash->store(key, depth, nodes);
+        return nodes;
+      }
+    };
+  }
+
+  PerftResult perft(const chess::Position &pos, int depth, const PerftOptions &opt)
+  {
+    PerftResult res;
+    const auto t0 = steady_clock::now();
+
+    if (depth <= 0)
+    {
+      res.nodes = 1;
+      return res;
+    }
+    depth = std::min(depth, MAX_PERFT_DEPTH - 1);
+
+    std::vector<chess::Move> root;
+    chess::MoveGenerator mg;
+    mg.generateLegalMoves(pos.getBoard(), pos.getState(), root);
+
+    PerftHash hash(opt.hashMb);
+    PerftHash *hp = hash.enabled() ? &hash : nullptr;
+
+    res.divide.resize(root.size());
+    for (std::size_t i = 0; i < root.size(); ++i)
+      res.divide[i].move = root[i];
+
+    auto count_root = [&](PerftWalker &w, std::size_t i)
+    {
+      if (w.stopped())
+        return;
+      w.pos.doLegalMove(root[i], w.st[0]);
+      res.divide[i].nodes = w.run(depth - 1, 1);
+      w.pos.undoMove();
+    };
+
+    if (opt.threads > 1 && root.size() > 1)
+    {
+      auto &pool = ThreadPool::instance();
+      pool.maybe_resize(opt.threads);
+      pool.parallel_for(0, root.size(), [&](std::size_t i)
+                        {
+        auto w = std::make_unique<PerftWalker>(pos, hp, opt);
+        count_root(*w, i); });
+    }
+    else
+    {
+      auto w = std::make_unique<PerftWalker>(pos, hp, opt);
+      for (std::size_t i = 0; i < root.size(); ++i)
+        count_root(*w, i);
+    }
+
+    for (const auto &d : res.divide)
+      res.nodes += d.nodes;
+    res.stopped = opt.stop && opt.stop->load(std::memory_order_relaxed);
+    res.elapsedMs = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(steady_clock::now() - t0).count());
+    return res;
+  }
+
+  std::span<const PerftCase> perft_suite()
+  {
+    return SUITE;
+  }
+
+  bool run_perft_suite(std::ostream &os, const PerftOptions &opt, int maxDepth)
+  {
+    bool ok = true;
+    std::uint64_t totalNodes = 0;
+    std::uint64_t totalMs = 0;
+
+    auto nps = [](std::uint64_t nodes, std::uint64_t ms)
+    { return ms ? nodes * 1000 / ms : nodes; };
+
+    for (const PerftCase &c : perft_suite())
+    {
+      const int depth = maxDepth > 0 ? std::min(c.depth, maxDepth) : c.depth;
+
+      chess::ChessGame game;
+      game.setPosition(c.fen);
+      const PerftResult r = perft(game.getPositionRefForBot(), depth, opt);
+      if (r.stopped)
+      {
+        os << c.name << " stopped\n";
+        return false;
+      }
+
+      const std::uint64_t expect = c.counts[static_cast<std::size_t>(depth)];
+      const bool pass = expect == 0 || r.nodes == expect;
+      ok = ok && pass;
+      totalNodes += r.nodes;
+      totalMs += r.elapsedMs;
+
+      os << std::left << std::setw(12) << c.name << std::right << " depth " << depth << " nodes "
+         << std::setw(10) << r.nodes << " time " << std::setw(6) << r.elapsedMs << " ms nps "
+         << nps(r.nodes, r.elapsedMs);
+      if (!pass)
+        os << "  MISMATCH (expected " << expect << ")";
+      os << "\n";
+    }
+
+    os << "Total nodes " << totalNodes << " time " << totalMs << " ms nps "
+       << nps(totalNodes, totalMs) << (ok ? "" : "  FAILED") << "\n";
+    return ok;
+  }
+
+}
@@ -7,11 +7,9 @@
 #include <cmath>
 #include <cstring>
 #include <exception>
-#include <future>
 #include <iostream>
 #include <limits>
 #include <memory>
-#include <mutex>
 #include <unordered_set>
 #include <vector>
 
@@ -22,6 +20,7 @@
 #include "lilia/engine/thread_pool.hpp"
 #include "lilia/chess/core/bitboard.hpp"
 #include "lilia/chess/core/magic.hpp"
+#include "lilia/chess/core/piece_encoding.hpp"
 #include "lilia/chess/compiler.hpp"
 
 namespace lilia::engine
@@ -123,6 +122,7 @@ namespace lilia::engine
     static constexpr int ORDER_HEAVY_QUIET_MALUS = 6000;
     static constexpr int ORDER_CHECK_BONUS = 90'000;
     static constexpr int ORDER_THREAT_BONUS = 40'000;
+    static constexpr int QUIET_SORT_DEPTH_LIMIT = 3000; // quiets below -limit*depth stay unsorted
 
     // Singular extension / ProbCut / LMR / check extensions
     static constexpr int SINGULAR_MIN_DEPTH = 6;
@@ -187,10 +187,8 @@ namespace lilia::engine
     static constexpr int QUIET_HIST_BLEND_SHIFT = 1;
     static constexpr int COUNTERMOVE_HIST_BLEND_SHIFT = 1;
     static constexpr int FAIL_LOW_HISTORY_SHIFT = 1;
-    static constexpr int CONTHIST_MALUS_SHIFT_L1 = 1;
-    static constexpr int CONTHIST_MALUS_SHIFT_L2 = 2;
-    static constexpr int CONTHIST_BONUS_SHIFT_L1 = 1;
-    static constexpr int CONTHIST_BONUS_SHIFT_L2 = 2;
+    static constexpr int CONTHIST_MALUS_SHIFT[CONTHIST_LAYERS] = {0, 1, 2};
+    static constexpr int CONTHIST_BONUS_SHIFT[CONTHIST_LAYERS] = {0, 1, 2};
 
     // Repeated depth gates
     static constexpr int SNMP_MAX_DEPTH = 3;
@@ -320,9 +318,7 @@ namespace lilia::engine
 
     static LILIA_ALWAYS_INLINE void reward_quiet_cutoff(
         Search &S, int ply, int depth, const chess::Move &m, chess::PieceType moverPt,
-        const chess::Move &prev, bool prevOk,
-        int pm1_to, int pm2_to, int pm3_to,
-        int pm1_pt, int pm2_pt, int pm3_pt)
+        const chess::Move &prev, bool prevOk, ContHistBlock *const cont[CONTHIST_LAYERS])
     {
       const int B = hist_bonus(depth);
       const int mp = chess::bb::type_index(moverPt);
@@ -333,12 +329,9 @@ namespace lilia::engine
       hist_update(S.history[m.from()][m.to()], +B);
       hist_update(S.quietHist[mp][m.to()], +B);
 
-      if (pm1_to >= 0 && pm1_pt >= 0)
-        hist_update(S.contHist[0][pm1_pt][pm1_to][mp][m.to()], +B);
-      if (pm2_to >= 0 && pm2_pt >= 0)
-        hist_update(S.contHist[1][pm2_pt][pm2_to][mp][m.to()], +(B >> CONTHIST_BONUS_SHIFT_L1));
-      if (pm3_to >= 0 && pm3_pt >= 0)
-        hist_update(S.contHist[2][pm3_pt][pm3_to][mp][m.to()], +(B >> CONTHIST_BONUS_SHIFT_L2));
+      for (int l = 0; l < CONTHIST_LAYERS; ++l)
+        if (cont[l])
+          hist_update(cont[l]->h[l][mp][m.to()], +(B >> CONTHIST_BONUS_SHIFT[l]));
 
       if (prevOk)
       {
@@ -356,8 +349,7 @@ namespace lilia::engine
 
     static LILIA_ALWAYS_INLINE void penalize_preceding_quiets(
         Search &S, int depth, const SearchedQuiet *quiets, int count,
-        int pm1_to, int pm2_to, int pm3_to,
-        int pm1_pt, int pm2_pt, int pm3_pt)
+        ContHistBlock *const cont[CONTHIST_LAYERS])
     {
       const int M = std::max(1, hist_bonus(depth) >> 1);
 
@@ -369,12 +361,9 @@ namespace lilia::engine
         hist_update(S.history[q.m.from()][q.m.to()], -M);
         hist_update(S.quietHist[mp][q.m.to()], -M);
 
-        if (pm1_to >= 0 && pm1_pt >= 0)
-          hist_update(S.contHist[0][pm1_pt][pm1_to][mp][q.m.to()], -M);
-        if (pm2_to >= 0 && pm2_pt >= 0)
-          hist_update(S.contHist[1][pm2_pt][pm2_to][mp][q.m.to()], -(M >> CONTHIST_MALUS_SHIFT_L1));
-        if (pm3_to >= 0 && pm3_pt >= 0)
-          hist_update(S.contHist[2][pm3_pt][pm3_to][mp][q.m.to()], -(M >> CONTHIST_MALUS_SHIFT_L2));
+        for (int l = 0; l < CONTHIST_LAYERS; ++l)
+          if (cont[l])
+            hist_update(cont[l]->h[l][mp][q.m.to()], -(M >> CONTHIST_MALUS_SHIFT[l]));
       }
     }
 
@@ -406,6 +395,12 @@ namespace lilia::engine
         applied = pos.doMove(m);
         return applied;
       }
+      // m must come from the (legal) move generator
+      LILIA_ALWAYS_INLINE bool doLegalMove(const chess::Move &m)
+      {
+        applied = pos.doLegalMove(m);
+        return applied;
+      }
       LILIA_ALWAYS_INLINE void rollback()
       {
         if (LILIA_UNLIKELY(applied))
@@ -456,7 +451,7 @@ namespace lilia::engine
                                            int cap)
     {
       chess::MoveBuffer buf(out, cap);
-      return mg.generatePseudoLegalMoves(pos.getBoard(), pos.getState(), buf);
+      return mg.generateLegalMoves(pos.getBoard(), pos.getState(), buf);
     }
     static LILIA_ALWAYS_INLINE int gen_caps(chess::MoveGenerator &mg, SearchPosition &pos, chess::Move *out,
                                             int cap)
@@ -559,15 +554,12 @@ namespace lilia::engine
         for (int t = 0; t < chess::SQ_NB; ++t)
           S.counterHist[f][t] = clamp16((int)S.counterHist[f][t] - ((int)S.counterHist[f][t] >> shift));
 
-      for (int L = 0; L < CONTHIST_LAYERS; ++L)
-        for (int pp = 0; pp < chess::PIECE_TYPE_NB; ++pp)
-          for (int pt = 0; pt < chess::SQ_NB; ++pt)
-            for (int mp = 0; mp < chess::PIECE_TYPE_NB; ++mp)
-              for (int to = 0; to < chess::SQ_NB; ++to)
-              {
-                int16_t &h = S.contHist[L][pp][pt][mp][to];
+      for (auto &row : S.contHist.v)
+        for (ContHistBlock &blk : row)
+          for (auto &layer : blk.h)
+            for (auto &piece : layer)
+              for (int16_t &h : piece)
                 h = clamp16((int)h - ((int)h >> shift));
-              }
     }
 
     // 0 = no signal; 1 = attacks high-value piece; 2 = gives check
@@ -580,10 +572,11 @@ namespace lilia::engine
       chess::bb::Bitboard BETWEEN[chess::SQ_NB][chess::SQ_NB];
       chess::bb::Bitboard RAY[chess::SQ_NB][chess::SQ_NB]; // ray starting at a towards b
       int DIR[chess::SQ_NB][chess::SQ_NB];                 // -1 if not aligned, else 0..7 for N,NE,E,SE,S,SW,W,NW
-    } CT;
+    };
 
-    static inline void init_check_tables()
+    static consteval CheckTables build_check_tables()
     {
+      CheckTables CT{};
       for (int s = 0; s < chess::SQ_NB; ++s)
       {
         CT.KN_FROM[s] = chess::bb::knight_attacks_from(static_cast<chess::Square>(s));
@@ -602,7 +595,7 @@ namespace lilia::engine
         int fa = chess::bb::file_of(static_cast<chess::Square>(a));
         int rb = chess::bb::rank_of(static_cast<chess::Square>(b));
         int fb = chess::bb::file_of(static_cast<chess::Square>(b));
-        return (ra == rb) || (fa == fb) || (std::abs(ra - rb) == std::abs(fa - fb));
+        return (ra == rb) || (fa == fb) || (ra - rb == fa - fb) || (ra - rb == fb - fa);
       };
 
       auto dir_from_to = [&](int a, int b) -> int
@@ -695,8 +688,11 @@ namespace lilia::engine
           }
           CT.LINE[a][b] = ray | rayOpp | A | B;
         }
+      return CT;
     }
 
+    static constexpr CheckTables CT = build_check_tables();
+
     struct QuietSignals
     {
       int pawnSignal = 0;
@@ -915,13 +911,432 @@ namespace lilia::engine
       return info;
     }
 
-    inline void ensure_check_tables_initialized()
+    // Per-node inputs of the move ordering score.
+    struct OrderContext
+    {
+      int kply = 0;
+      chess::Move ttMove{};
+      chess::Move prev{}; // opponent's last move
+      bool prevOk = false;
+      chess::Move counter{};
+      const ContHistBlock *cont[CONTHIST_LAYERS] = {};
+    };
+
+    // stage * ORDER_BUCKET + base; the bucket decides which picker stage a tactical move
+    // belongs to, the full score the order within a stage. hist is the move's
+    // history_scores() entry.
+    static int score_move(const Search &S, const SearchPosition &pos, const OrderContext &c,
+                          const chess::Move &m, int hist)
     {
-      static std::once_flag init_flag;
-      std::call_once(init_flag, []
-                     { init_check_tables(); });
+      const auto &board = pos.getBoard();
+
+      int stage = ORDER_STAGE_QUIET;
+      int base = 0;
+
+      const bool isCap = m.isCapture();
+      const bool isPromo = (m.promotion() != chess::PieceType::None);
+
+      const int mp = std::max(0, chess::decode_ti(board.getPiecePacked(m.from())));
+      const auto moverPt = static_cast<chess::PieceType>(mp);
+
+      chess::PieceType capPt = chess::PieceType::Pawn;
+      if (isCap && !m.isEnPassant())
+        capPt = static_cast<chess::PieceType>(std::max(0, chess::decode_ti(board.getPiecePacked(m.to()))));
+
+      if (m == c.ttMove)
+      {
+        stage = ORDER_STAGE_TT;
+        base = ORDER_TT_BONUS;
+      }
+      else if (isCap)
+      {
+        const bool isRecap = (!c.prev.isNull() && c.prev.to() == m.to());
+        const bool seeGood = isPromo || pos.see(m);
+        const int mvv = mvv_lva(pos.position(), m);
+        const int ch = hist;
+        const bool bigVictim = (capPt == chess::PieceType::Rook || capPt == chess::PieceType::Queen);
+
+        if (seeGood || isRecap || bigVictim)
+        {
+          stage = ORDER_STAGE_GOOD_CAP;
+          base = ORDER_GOOD_CAPTURE_BASE + mvv + (ch >> 1);
+        }
+        else
+        {
+          stage = ORDER_STAGE_BAD_CAP;
+          base = ORDER_BAD_CAPTURE_BASE + mvv + (ch >> 2);
+        }
+      }
+      else if (isPromo)
+      {
+        stage = ORDER_STAGE_KILLER_CM_QP;
+        base = ORDER_PROMO_BASE;
+      }
+      else if (m == S.killers[c.kply][0] || m == S.killers[c.kply][1])
+      {
+        stage = ORDER_STAGE_KILLER_CM_QP;
+        base = ORDER_KILLER_BASE;
+      }
+      else if (c.prevOk && m == c.counter)
+      {
+        stage = ORDER_STAGE_KILLER_CM_QP;
+        base = ORDER_COUNTERMOVE_BASE +
+               (S.counterHist[c.prev.from()][c.prev.to()] >> COUNTERMOVE_HIST_BLEND_SHIFT);
+      }
+      else
+      {
+        base = hist;
+        if (moverPt == chess::PieceType::Queen || moverPt == chess::PieceType::Rook)
+          base -= ORDER_HEAVY_QUIET_MALUS;
+      }
+
+      const auto sig = compute_quiet_signals(pos, m);
+      if (sig.givesCheck)
+      {
+        stage = std::max(stage, int(ORDER_STAGE_KILLER_CM_QP));
+        base += ORDER_CHECK_BONUS;
+      }
+      else if (sig.pawnSignal > 0 || sig.pieceSignal > 0)
+      {
+        stage = std::max(stage, int(ORDER_STAGE_KILLER_CM_QP));
+        base += ORDER_THREAT_BONUS;
+      }
+
+      return stage * ORDER_BUCKET + base;
     }
 
+    // Hands out the moves of one negamax node in stages, so a cutoff early in the list
+    // never pays for the rest: TT move, good captures, promotions/killers/countermove
+    // (and losing captures that give check), quiets, losing captures. Quiets are only
+    // generated when that stage is reached and are only sorted above a depth-scaled
+    // history limit. In check, all evasions are scored and sorted up front.
+    //
+    // Moves live in the picker itself (on the caller's stack): singular verification
+    // re-searches the same ply and must not overwrite them.
+    class MovePicker
+    {
+    public:
+      MovePicker(const Search &S, chess::MoveGenerator &mg, const SearchPosition &pos,
+                 const OrderContext &ctx, bool inCheck, int depth)
+          : S_(S), mg_(mg), pos_(pos), ctx_(ctx), depth_(depth),
+            stage_(inCheck ? Stage::Evasions : Stage::TT)
+      {
+        hist_.fromTo = &S.history[0][0];
+        hist_.pieceTo = &S.quietHist[0][0];
+        hist_.capture = &S.captureHist[0][0][0];
+        hist_.pieceToShift = QUIET_HIST_BLEND_SHIFT;
+        for (int l = 0; l < CONTHIST_LAYERS; ++l)
+          if (ctx.cont[l])
+            hist_.cont[l] = &ctx.cont[l]->h[l][0][0];
+      }
+
+      // Null when exhausted.
+      chess::Move next()
+      {
+        switch (stage_)
+        {
+        case Stage::TT:
+          stage_ = Stage::Tactical;
+          if (tt_playable())
+          {
+            moves_[end_++] = ctx_.ttMove;
+            ttYielded_ = true;
+            unverified_ = true;
+            return take(cur_++);
+          }
+          [[fallthrough]];
+
+        case Stage::Tactical:
+          gen_tactical();
+          stage_ = Stage::GoodCaptures;
+          [[fallthrough]];
+
+        case Stage::GoodCaptures:
+          unverified_ = false;
+          if (cur_ < goodEnd_)
+            return take(select_best(cur_++, goodEnd_));
+          add_refutations();
+          stage_ = Stage::Refutations;
+          [[fallthrough]];
+
+        case Stage::Refutations:
+          if (cur_ < refEnd_)
+          {
+            const int i = select_best(cur_++, refEnd_);
+            // killers and the countermove were only checked for pseudo-legality
+            unverified_ = !moves_[i].isCapture() && moves_[i].promotion() == chess::PieceType::None;
+            return take(i);
+          }
+          unverified_ = false;
+          gen_quiets();
+          stage_ = Stage::Quiets;
+          [[fallthrough]];
+
+        case Stage::Quiets:
+          if (quietCur_ < end_)
+            return take(quietCur_++);
+          stage_ = Stage::BadCaptures;
+          [[fallthrough]];
+
+        case Stage::BadCaptures:
+          if (badCur_ < badEnd_)
+            return take(select_best(badCur_++, badEnd_));
+          stage_ = Stage::Done;
+          return chess::Move{};
+
+        case Stage::Evasions:
+          gen_evasions();
+          stage_ = Stage::EvasionList;
+          [[fallthrough]];
+
+        case Stage::EvasionList:
+          if (cur_ < end_)
+            return take(cur_++);
+          stage_ = Stage::Done;
+          return chess::Move{};
+
+        case Stage::Done:
+          break;
+        }
+        return chess::Move{};
+      }
+
+      // The last move did not come from the legal generator (TT move, killer, countermove):
+      // make it with the checked doMove().
+      [[nodiscard]] bool needs_legality_check() const noexcept { return unverified_; }
+
+      // Moves handed out so far, in order.
+      [[nodiscard]] int yielded_count() const noexcept { return yielded_; }
+      [[nodiscard]] chess::Move yielded(int i) const noexcept { return moves_[order_[i]]; }
+
+    private:
+      enum class Stage : std::uint8_t
+      {
+        TT,
+        Tactical,
+        GoodCaptures,
+        Refutations,
+        Quiets,
+        BadCaptures,
+        Evasions,
+        EvasionList,
+        Done
+      };
+
+      LILIA_ALWAYS_INLINE chess::Move take(int i) noexcept
+      {
+        order_[yielded_++] = static_cast<std::uint8_t>(i);
+        return moves_[i];
+      }
+
+      // Swaps the best of [from, to) into from.
+      LILIA_ALWAYS_INLINE int select_best(int from, int to) noexcept
+      {
+        int best = from;
+        for (int i = from + 1; i < to; ++i)
+          if (scores_[i] > scores_[best])
+            best = i;
+        std::swap(moves_[from], moves_[best]);
+        std::swap(scores_[from], scores_[best]);
+        return from;
+      }
+
+      // History for the whole batch in one kernel call, then the per-move stage logic.
+      void score_range(int from, int to)
+      {
+        history_scores(hist_, pos_.getBoard(), moves_ + from, to - from, scores_ + from);
+        for (int i = from; i < to; ++i)
+          scores_[i] = score_move(S_, pos_, ctx_, moves_[i], scores_[i]);
+      }
+
+      bool tt_playable() const
+      {
+        const chess::Move m = ctx_.ttMove;
+        if (m.isNull() || !pos_.isPseudoLegal(m))
+          return false;
+        // isPseudoLegal() reads the board, not the flags; a stale move must match both.
+        if (m.isEnPassant())
+          return true;
+        return m.isCapture() == pos_.getBoard().getPiece(m.to()).has_value();
+      }
+
+      bool is_refutation_quiet(const chess::Move &m) const noexcept
+      {
+        for (int i = 0; i < nRefQuiets_; ++i)
+          if (refQuiets_[i] == m)
+            return true;
+        return false;
+      }
+
+      // [cur_, goodEnd_) winning captures | [goodEnd_, refEnd_) quiet promotions and
+      // checking losing captures | [badCur_, badEnd_) other losing captures.
+      void gen_tactical()
+      {
+        chess::MoveBuffer buf(moves_ + end_, MAX_MOVES - end_);
+        const int n = mg_.generateTacticalMoves(pos_.getBoard(), pos_.getState(), buf);
+
+        int w = end_;
+        for (int i = end_; i < end_ + n; ++i)
+          if (!(ttYielded_ && moves_[i] == ctx_.ttMove))
+            moves_[w++] = moves_[i];
+        score_range(end_, w);
+
+        // three-way partition by bucket
+        int lo = end_, mid = end_, hi = w;
+        while (mid < hi)
+        {
+          const int bucket = scores_[mid] / ORDER_BUCKET;
+          if (bucket >= ORDER_STAGE_GOOD_CAP)
+          {
+            std::swap(moves_[lo], moves_[mid]);
+            std::swap(scores_[lo++], scores_[mid++]);
+          }
+          else if (bucket <= ORDER_STAGE_BAD_CAP)
+          {
+            --hi;
+            std::swap(moves_[mid], moves_[hi]);
+            std::swap(scores_[mid], scores_[hi]);
+          }
+          else
+            ++mid;
+        }
+        goodEnd_ = lo;
+        refEnd_ = mid;
+        badCur_ = mid;
+        badEnd_ = end_ = w;
+      }
+
+      // Killers and the countermove join the refutation group if they are still quiet
+      // and pseudo-legal here; the losing captures move up to make room.
+      void add_refutations()
+      {
+        const chess::Move cand[3] = {S_.killers[ctx_.kply][0], S_.killers[ctx_.kply][1],
+                                     ctx_.prevOk ? ctx_.counter : chess::Move{}};
+        const auto &board = pos_.getBoard();
+        for (const chess::Move &m : cand)
+        {
+          if (m.isNull() || m.isCapture() || m.promotion() != chess::PieceType::None)
+            continue;
+          if (m == ctx_.ttMove || is_refutation_quiet(m))
+            continue;
+          if (board.getPiece(m.to()) || !pos_.isPseudoLegal(m))
+            continue;
+          refQuiets_[nRefQuiets_++] = m;
+        }
+        if (!nRefQuiets_)
+          return;
+
+        for (int i = badEnd_ - 1; i >= badCur_; --i)
+        {
+          moves_[i + nRefQuiets_] = moves_[i];
+          scores_[i + nRefQuiets_] = scores_[i];
+        }
+        for (int k = 0; k < nRefQuiets_; ++k)
+          moves_[refEnd_ + k] = refQuiets_[k];
+        score_range(refEnd_, refEnd_ + nRefQuiets_);
+        refEnd_ += nRefQuiets_;
+        badCur_ += nRefQuiets_;
+        badEnd_ += nRefQuiets_;
+        end_ = badEnd_;
+      }
+
+      void gen_quiets()
+      {
+        quietCur_ = end_;
+        chess::MoveBuffer buf(moves_ + end_, MAX_MOVES - end_);
+        const int n = mg_.generateQuietMoves(pos_.getBoard(), pos_.getState(), buf);
+
+        int w = end_;
+        for (int i = end_; i < end_ + n; ++i)
+        {
+          const chess::Move m = moves_[i];
+          if ((ttYielded_ && m == ctx_.ttMove) || is_refutation_quiet(m))
+            continue;
+          moves_[w++] = m;
+        }
+        score_range(end_, w);
+        end_ = w;
+
+        // Insertion sort of the scores above the limit to the front; the tail keeps
+        // generation order and is mostly pruned by move count anyway.
+        const int limit = ORDER_STAGE_QUIET * ORDER_BUCKET - QUIET_SORT_DEPTH_LIMIT * depth_;
+        int sortedEnd = quietCur_;
+        for (int p = quietCur_; p < end_; ++p)
+        {
+          if (scores_[p] < limit)
+            continue;
+          const chess::Move m = moves_[p];
+          const int s = scores_[p];
+          moves_[p] = moves_[sortedEnd];
+          scores_[p] = scores_[sortedEnd];
+          int q = sortedEnd++;
+          for (; q > quietCur_ && scores_[q - 1] < s; --q)
+          {
+            moves_[q] = moves_[q - 1];
+            scores_[q] = scores_[q - 1];
+          }
+          moves_[q] = m;
+          scores_[q] = s;
+        }
+      }
+
+      void gen_evasions()
+      {
+        chess::MoveBuffer buf(moves_, MAX_MOVES);
+        end_ = mg_.generateEvasions(pos_.getBoard(), pos_.getState(), buf);
+        score_range(0, end_);
+        sort_by_score_desc(scores_, moves_, end_);
+      }
+
+      const Search &S_;
+      chess::MoveGenerator &mg_;
+      const SearchPosition &pos_;
+      const OrderContext &ctx_;
+      OrderHistory hist_;
+      int depth_;
+      Stage stage_;
+      bool ttYielded_ = false;
+      bool unverified_ = false;
+
+      int cur_ = 0, end_ = 0;
+      int goodEnd_ = 0, refEnd_ = 0;
+      int badCur_ = 0, badEnd_ = 0;
+      int quietCur_ = 0;
+      int yielded_ = 0;
+
+      chess::Move refQuiets_[3];
+      int nRefQuiets_ = 0;
+
+      chess::Move moves_[MAX_MOVES];
+      int scores_[MAX_MOVES];
+      std::uint8_t order_[MAX_MOVES];
+    };
+
+  }
+
+  SearchCounters &SearchCounters::operator+=(const SearchCounters &o) noexcept
+  {
+    nodes += o.nodes;
+    qnodes += o.qnodes;
+    ttProbes += o.ttProbes;
+    for (std::size_t i = 0; i < ttHits.size(); ++i)
+      ttHits[i] += o.ttHits[i];
+    betaCutoffs += o.betaCutoffs;
+    firstMoveCutoffs += o.firstMoveCutoffs;
+    nullTries += o.nullTries;
+    nullCutoffs += o.nullCutoffs;
+    nullVerifyFails += o.nullVerifyFails;
+    probCutTries += o.probCutTries;
+    probCutCutoffs += o.probCutCutoffs;
+    lmrReduced += o.lmrReduced;
+    lmrResearches += o.lmrResearches;
+    aspFailHigh += o.aspFailHigh;
+    aspFailLow += o.aspFailLow;
+    evalHashProbes += o.evalHashProbes;
+    evalHashHits += o.evalHashHits;
+    for (std::size_t d = 0; d < depthNodes.size(); ++d)
+      depthNodes[d] += o.depthNodes[d];
+    return *this;
   }
 
   Search::Search(TT &tt_, const EngineConfig &cfg_)
@@ -932,12 +1347,12 @@ namespace lilia::engine
       kk[0] = chess::Move{};
       kk[1] = chess::Move{};
     }
-    for (auto &h : history)
+    for (auto &h : history.v)
       h.fill(0);
     std::fill(&quietHist[0][0], &quietHist[0][0] + chess::PIECE_TYPE_NB * chess::SQ_NB, 0);
     std::fill(&captureHist[0][0][0], &captureHist[0][0][0] + chess::PIECE_TYPE_NB * chess::SQ_NB * chess::PIECE_TYPE_NB, 0);
     std::fill(&counterHist[0][0], &counterHist[0][0] + chess::SQ_NB * chess::SQ_NB, 0);
-    std::memset(contHist, 0, sizeof(contHist));
+    std::memset(contHist.v, 0, sizeof(contHist.v));
     for (auto &row : counterMove)
       for (auto &m : row)
         m = chess::Move{};
@@ -949,7 +1364,16 @@ namespace lilia::engine
     sharedNodes.reset();
     nodeLimit = 0;
     stats = SearchStats{};
-    ensure_check_tables_initialized();
+  }
+
+  void Search::set_time_control(TimeManager *tm, const std::atomic<bool> *externalStop)
+  {
+    tm_ = tm;
+    stopCheck_ = StopCheck{};
+    stopCheck_.external = externalStop;
+    if (tm && tm->active())
+      stopCheck_.deadline = tm->hard_deadline();
+    activeStopCheck_ = (tm || externalStop) ? &stopCheck_ : nullptr;
   }
 
   int Search::signed_eval(SearchPosition &pos)
@@ -960,6 +1384,13 @@ namespace lilia::engine
     return std::clamp(v, -MATE + 1, MATE - 1);
   }
 
+  int Search::signed_eval(SearchPosition &pos, int alpha, int beta, bool &exact)
+  {
+    const bool white = pos.getState().sideToMove == chess::Color::White;
+    int v = white ? eval_.evaluate(pos, alpha, beta, exact) : -eval_.evaluate(pos, -beta, -alpha, exact);
+    return std::clamp(v, -MATE + 1, MATE - 1);
+  }
+
   namespace
   {
 
@@ -969,13 +1400,20 @@ namespace lilia::engine
       LILIA_ALWAYS_INLINE void reset() { local_ = 0; }
 
       LILIA_ALWAYS_INLINE void bump(const std::shared_ptr<std::atomic<std::uint64_t>> &counter, std::uint64_t limit,
-                                    const std::shared_ptr<std::atomic<bool>> &stopFlag)
+                                    const std::shared_ptr<std::atomic<bool>> &stopFlag, const StopCheck *check)
       {
         ++local_;
         if (LILIA_UNLIKELY((local_ & STOP_POLL_MASK) == 0u))
         {
           if (stopFlag && stopFlag->load(std::memory_order_relaxed))
             throw SearchStoppedException();
+          if (check && check->expired())
+          {
+            // hard deadline / GUI stop: also release the helpers
+            if (stopFlag)
+              stopFlag->store(true, std::memory_order_relaxed);
+            throw SearchStoppedException();
+          }
         }
 
         if (LILIA_UNLIKELY(local_ >= NODE_BATCH_TICK_STEP))
@@ -1061,14 +1499,16 @@ namespace lilia::engine
 
   LILIA_ALWAYS_INLINE void bump_node_or_stop(const std::shared_ptr<std::atomic<std::uint64_t>> &counter,
                                              std::uint64_t limit,
-                                             const std::shared_ptr<std::atomic<bool>> &stopFlag)
+                                             const std::shared_ptr<std::atomic<bool>> &stopFlag,
+                                             const StopCheck *check)
   {
-    node_batch().bump(counter, limit, stopFlag);
+    node_batch().bump(counter, limit, stopFlag, check);
   }
 
-  int Search::quiescence(SearchPosition &pos, int alpha, int beta, int ply)
+  int Search::quiescence(SearchPosition &pos, int alpha, int beta, int ply, int qdepth)
   {
-    bump_node_or_stop(sharedNodes, nodeLimit, stopFlag);
+    bump_node_or_stop(sharedNodes, nodeLimit, stopFlag, activeStopCheck_);
+    ++stats.counters.qnodes;
 
     if (ply >= MAX_PLY - 2)
       return signed_eval(pos);
@@ -1088,8 +1528,10 @@ namespace lilia::engine
     // QTT probe (depth == 0)
     {
       TTEntry tte{};
+      ++stats.counters.ttProbes;
       if (tt.probe_into(parentKey, tte))
       {
+        ++stats.counters.ttHits[static_cast<std::size_t>(tte.bound)];
         ttSE = tte.staticEval;
 
         if (tte.bound != Bound::None)
@@ -1158,7 +1600,7 @@ namespace lilia::engine
         const chess::PieceType movedPt = moved_piece_after(pos, m);
 
         MoveUndoGuard g(pos);
-        if (!g.doMove(m))
+        if (!g.doLegalMove(m))
           continue;
 
         prevMove[cap_ply(ply)] = m;
@@ -1166,7 +1608,7 @@ namespace lilia::engine
         anyLegal = true;
 
         tt.prefetch(pos.hash());
-        int score = -quiescence(pos, -beta, -alpha, ply + 1);
+        int score = -quiescence(pos, -beta, -alpha, ply + 1, qdepth + 1);
         score = std::clamp(score, -MATE + 1, MATE - 1);
 
         if (score >= beta)
@@ -1206,28 +1648,32 @@ namespace lilia::engine
       return best;
     }
 
-    const int stand = (ttSE != TT_SE_UNSET ? (int)ttSE : signed_eval(pos));
+    // A lazy stand-pat only says which side of [alpha, beta] the eval is on. Above beta it is
+    // good for a fail-hard cutoff; below alpha the exact eval is computed, since delta
+    // pruning, the quiet-check gate and the returned score all need the real value.
+    bool standExact = true;
+    int stand = (ttSE != TT_SE_UNSET ? (int)ttSE : signed_eval(pos, alpha, beta, standExact));
+    if (!standExact && stand < beta)
+    {
+      stand = signed_eval(pos);
+      standExact = true;
+    }
 
     if (stand >= beta)
     {
+      const int v = standExact ? stand : beta;
       if (!(stopFlag && stopFlag->load()))
-      {
-        constexpr int16_t SE_UNSET = std::numeric_limits<int16_t>::min();
-        tt.store(parentKey, encode_tt_score(stand, kply), 0, Bound::Lower, chess::Move{},
-                 (int16_t)stand);
-      }
-      return stand;
+        tt.store(parentKey, encode_tt_score(v, kply), 0, Bound::Lower, chess::Move{},
+                 standExact ? static_cast<int16_t>(stand) : TT_SE_UNSET);
+      return v;
     }
+    const int16_t standSE = static_cast<int16_t>(stand);
+
     if (alpha < stand)
       alpha = stand;
 
-    // Generate captures (+ non-capture promotions)
+    // Captures + promotions (the tactical set already includes quiet promotions)
     int qn = gen_caps(mg, pos, capArr_[kply], MAX_MOVES);
-    if (qn < MAX_MOVES)
-    {
-      chess::MoveBuffer buf(capArr_[kply] + qn, MAX_MOVES - qn);
-      qn += mg.generateNonCapturePromotions(pos.getBoard(), pos.getState(), buf);
-    }
 
     // Order captures/promos
     int *qs = ordScore_[kply];
@@ -1342,7 +1788,7 @@ namespace lilia::engine
           {
             // Quick discovered-check safety: if the move actually gives check, don't prune
             MoveUndoGuard cg(pos);
-            if (cg.doMove(m) && pos.lastMoveGaveCheck())
+            if (cg.doLegalMove(m) && pos.lastMoveGaveCheck())
             {
               cg.rollback(); // fall through to normal search
             }
@@ -1358,19 +1804,19 @@ namespace lilia::engine
       const chess::PieceType movedPt = moved_piece_after(pos, m);
 
       MoveUndoGuard g(pos);
-      if (!g.doMove(m))
+      if (!g.doLegalMove(m))
         continue;
 
       prevMove[cap_ply(ply)] = m;
       prevMovedPiece[cap_ply(ply)] = movedPt;
       tt.prefetch(pos.hash());
-      int score = -quiescence(pos, -beta, -alpha, ply + 1);
+      int score = -quiescence(pos, -beta, -alpha, ply + 1, qdepth + 1);
       score = std::clamp(score, -MATE + 1, MATE - 1);
 
       if (score >= beta)
       {
         if (!(stopFlag && stopFlag->load()))
-          tt.store(parentKey, encode_tt_score(score, kply), 0, Bound::Lower, m, (int16_t)stand);
+          tt.store(parentKey, encode_tt_score(score, kply), 0, Bound::Lower, m, standSE);
         return score;
       }
       if (score > alpha)
@@ -1382,8 +1828,9 @@ namespace lilia::engine
       }
     }
 
-    // --- limited quiet checks in qsearch (not just low material) ---
-    if (best < beta)
+    // --- limited quiet checks, first qsearch ply only (deeper ones chain into perpetual
+    // check trees that never resolve) ---
+    if (best < beta && qdepth == 0)
     {
       // MATERIAL gate: don't add quiet checks in bare endgames (king chases)
       auto countSideNP = [&](chess::Color c)
@@ -1433,20 +1880,19 @@ namespace lilia::engine
             const chess::PieceType movedPt = moved_piece_after(pos, m);
 
             MoveUndoGuard g(pos);
-            if (!g.doMove(m))
+            if (!g.doLegalMove(m))
               continue;
 
             prevMove[cap_ply(ply)] = m;
             prevMovedPiece[cap_ply(ply)] = movedPt;
-            int score = -quiescence(pos, -beta, -alpha, ply + 1);
+            int score = -quiescence(pos, -beta, -alpha, ply + 1, qdepth + 1);
             score = std::clamp(score, -MATE + 1, MATE - 1);
             ++tried;
 
             if (score >= beta)
             {
               if (!(stopFlag && stopFlag->load()))
-                tt.store(parentKey, encode_tt_score(score, kply), 0, Bound::Lower, m,
-                         (int16_t)stand);
+                tt.store(parentKey, encode_tt_score(score, kply), 0, Bound::Lower, m, standSE);
               return score;
             }
             if (score > best)
@@ -1465,7 +1911,7 @@ namespace lilia::engine
         b = Bound::Upper;
       else if (best >= betaOrig)
         b = Bound::Lower;
-      tt.store(parentKey, encode_tt_score(best, kply), 0, b, bestMoveQ, (int16_t)stand);
+      tt.store(parentKey, encode_tt_score(best, kply), 0, b, bestMoveQ, standSE);
     }
     return best;
   }
@@ -1473,7 +1919,8 @@ namespace lilia::engine
   int Search::negamax(SearchPosition &pos, int depth, int alpha, int beta, int ply,
                       chess::Move &refBest, int parentStaticEval, const chess::Move *excludedMove)
   {
-    bump_node_or_stop(sharedNodes, nodeLimit, stopFlag);
+    bump_node_or_stop(sharedNodes, nodeLimit, stopFlag, activeStopCheck_);
+    ++stats.counters.nodes;
 
     const std::uint64_t nodeKey = pos.hash();
 
@@ -1507,8 +1954,10 @@ namespace lilia::engine
     int ttStoredDepth = -1;
     int16_t ttSE = TT_SE_UNSET;
 
+    ++stats.counters.ttProbes;
     if (TTEntry tte{}; tt.probe_into(nodeKey, tte))
     {
+      ++stats.counters.ttHits[static_cast<std::size_t>(tte.bound)];
       haveTT = true;
       ttMove = tte.best;
       ttBound = tte.bound;
@@ -1658,8 +2107,9 @@ namespace lilia::engine
     bool hasQuickQuietCheck = false;
     if (!inCheck && !isPV && depth <= QUICK_CHECK_PROBE_MAX_DEPTH)
     {
+      // The generator always needs a full MAX_MOVES buffer; the cap only limits the scan.
       int probeCap = std::min(MAX_MOVES, QUICK_CHECK_PROBE_MOVE_CAP);
-      int probeN = gen_all(mg, pos, genArr_[cap_ply(ply)], probeCap);
+      int probeN = gen_all(mg, pos, genArr_[cap_ply(ply)], MAX_MOVES);
       for (int i = 0; i < probeN && i < probeCap; ++i)
       {
         const auto &mm = genArr_[cap_ply(ply)][i];
@@ -1708,6 +2158,7 @@ namespace lilia::engine
         NullUndoGuard ng(pos);
         if (ng.doNull())
         {
+          ++stats.counters.nullTries;
           chess::Move tmpNM{};
           int nullScore = -negamax(pos, depth - 1 - R, -beta, -beta + 1, ply + 1, tmpNM, -staticEval);
           ng.rollback();
@@ -1723,15 +2174,18 @@ namespace lilia::engine
                   -negamax(pos, depth - 1, -beta, -beta + 1, ply + 1, tmpVerify, -staticEval);
               if (verify >= beta)
               {
+                ++stats.counters.nullCutoffs;
                 if (!(stopFlag && stopFlag->load(std::memory_order_relaxed)))
                   tt.store(nodeKey, encode_tt_score(verify, cap_ply(ply)),
                            static_cast<int16_t>(depth), Bound::Lower, chess::Move{},
                            inCheck ? TT_SE_UNSET : static_cast<int16_t>(staticEval));
                 return verify;
               }
+              ++stats.counters.nullVerifyFails;
             }
             else
             {
+              ++stats.counters.nullCutoffs;
               if (!(stopFlag && stopFlag->load(std::memory_order_relaxed)))
                 tt.store(nodeKey, encode_tt_score(nullScore, cap_ply(ply)),
                          static_cast<int16_t>(depth), Bound::Lower, chess::Move{},
@@ -1744,172 +2198,33 @@ namespace lilia::engine
     }
 
     const int kply = cap_ply(ply);
-    int n = 0;
-    if (inCheck)
-    {
-      n = gen_evasions(mg, pos, genArr_[kply], MAX_MOVES);
-      if (n <= 0)
-        return mated_in(ply);
-    }
-    else
-    {
-      n = gen_all(mg, pos, genArr_[kply], MAX_MOVES);
-      if (n <= 0)
-        return 0;
-    }
-
     const chess::Move prev = (ply > 0 ? prevMove[cap_ply(ply - 1)] : chess::Move{});
     const bool prevOk = !prev.isNull() && prev.from() != prev.to();
     const chess::Move cm = prevOk ? counterMove[prev.from()][prev.to()] : chess::Move{};
 
-    // predecessor context: compute once, use both for ordering and history updates
-    int pm1_to = -1, pm2_to = -1, pm3_to = -1;
-    int pm1_pt = -1, pm2_pt = -1, pm3_pt = -1;
-
-    if (ply >= 1)
-    {
-      const int p = cap_ply(ply - 1);
-      if (!prevMove[p].isNull() && prevMovedPiece[p] != chess::PieceType::None)
-      {
-        pm1_to = prevMove[p].to();
-        pm1_pt = chess::bb::type_index(prevMovedPiece[p]);
-      }
-    }
-    if (ply >= 2)
-    {
-      const int p = cap_ply(ply - 2);
-      if (!prevMove[p].isNull() && prevMovedPiece[p] != chess::PieceType::None)
-      {
-        pm2_to = prevMove[p].to();
-        pm2_pt = chess::bb::type_index(prevMovedPiece[p]);
-      }
-    }
-    if (ply >= 3)
+    // predecessor context: compute once, use both for ordering and history updates.
+    // cont[l] is the block of the move l+1 plies back (null after a null move or at the root).
+    ContHistBlock *cont[CONTHIST_LAYERS] = {};
+    for (int l = 0; l < CONTHIST_LAYERS && l < ply; ++l)
     {
-      const int p = cap_ply(ply - 3);
+      const int p = cap_ply(ply - 1 - l);
       if (!prevMove[p].isNull() && prevMovedPiece[p] != chess::PieceType::None)
-      {
-        pm3_to = prevMove[p].to();
-        pm3_pt = chess::bb::type_index(prevMovedPiece[p]);
-      }
+        cont[l] = &contHist[chess::bb::type_index(prevMovedPiece[p])][prevMove[p].to()];
     }
 
     // --------- Staged move ordering ---------
-    int *scores = ordScore_[kply];
-    chess::Move *ordered = ordArr_[kply];
-
-    const auto &board = pos.getBoard();
-
-    for (int i = 0; i < n; ++i)
-    {
-      const auto &m = genArr_[kply][i];
-
-      int stage = ORDER_STAGE_QUIET;
-      int base = 0;
+    OrderContext octx;
+    octx.kply = kply;
+    octx.ttMove = haveTT ? ttMove : chess::Move{};
+    octx.prev = prev;
+    octx.prevOk = prevOk;
+    octx.counter = cm;
+    for (int l = 0; l < CONTHIST_LAYERS; ++l)
+      octx.cont[l] = cont[l];
 
-      const bool isCap = m.isCapture();
-      const bool isPromo = (m.promotion() != chess::PieceType::None);
-
-      auto moverOpt = board.getPiece(m.from());
-      const chess::PieceType moverPt = moverOpt ? moverOpt->type : chess::PieceType::Pawn;
-      const int mp = chess::bb::type_index(moverPt);
-
-      chess::PieceType capPt = chess::PieceType::Pawn;
-      if (m.isEnPassant())
-        capPt = chess::PieceType::Pawn;
-      else if (isCap)
-      {
-        if (auto cap = board.getPiece(m.to()))
-          capPt = cap->type;
-      }
-
-      const chess::Move pm = (ply > 0 ? prevMove[cap_ply(ply - 1)] : chess::Move{});
-      const bool isRecap = (!pm.isNull() && pm.to() == m.to());
-
-      bool seeGoodLocal = true;
-      if (isCap && !isPromo)
-        seeGoodLocal = pos.see(m);
-
-      if (haveTT && m == ttMove)
-      {
-        stage = ORDER_STAGE_TT;
-        base = ORDER_TT_BONUS;
-      }
-      else if (isCap)
-      {
-        const int mvv = mvv_lva(pos.position(), m);
-        const int ch = captureHist[mp][m.to()][chess::bb::type_index(capPt)];
-        const bool bigVictim = (capPt == chess::PieceType::Rook || capPt == chess::PieceType::Queen);
-        const bool good = seeGoodLocal || isRecap || bigVictim || isPromo;
+    MovePicker picker(*this, mg, pos, octx, inCheck, depth);
 
-        if (good)
-        {
-          stage = ORDER_STAGE_GOOD_CAP;
-          base = ORDER_GOOD_CAPTURE_BASE + mvv + (ch >> 1);
-        }
-        else
-        {
-          stage = ORDER_STAGE_BAD_CAP;
-          base = ORDER_BAD_CAPTURE_BASE + mvv + (ch >> 2);
-        }
-      }
-      else if (isPromo)
-      {
-        stage = ORDER_STAGE_KILLER_CM_QP;
-        base = ORDER_PROMO_BASE;
-      }
-      else if (m == killers[kply][0] || m == killers[kply][1])
-      {
-        stage = ORDER_STAGE_KILLER_CM_QP;
-        base = ORDER_KILLER_BASE;
-      }
-      else if (prevOk && m == cm)
-      {
-        stage = ORDER_STAGE_KILLER_CM_QP;
-        base = ORDER_COUNTERMOVE_BASE +
-               (counterHist[prev.from()][prev.to()] >> COUNTERMOVE_HIST_BLEND_SHIFT);
-      }
-      else
-      {
-        int cont = 0;
-        if (pm1_to >= 0 && pm1_pt >= 0)
-          cont += contHist[0][pm1_pt][pm1_to][mp][m.to()];
-        if (pm2_to >= 0 && pm2_pt >= 0)
-          cont += (contHist[1][pm2_pt][pm2_to][mp][m.to()] >> 1);
-        if (pm3_to >= 0 && pm3_pt >= 0)
-          cont += (contHist[2][pm3_pt][pm3_to][mp][m.to()] >> 1);
-
-        base = history[m.from()][m.to()] +
-               (quietHist[mp][m.to()] >> QUIET_HIST_BLEND_SHIFT) +
-               cont;
-
-        if (moverPt == chess::PieceType::Queen || moverPt == chess::PieceType::Rook)
-          base -= ORDER_HEAVY_QUIET_MALUS;
-
-        stage = ORDER_STAGE_QUIET;
-      }
-
-      {
-        const auto sig = compute_quiet_signals(pos, m);
-        if (sig.givesCheck)
-        {
-          if (stage < ORDER_STAGE_KILLER_CM_QP)
-            stage = ORDER_STAGE_KILLER_CM_QP;
-          base += ORDER_CHECK_BONUS;
-        }
-        else if (sig.pawnSignal > 0 || sig.pieceSignal > 0)
-        {
-          if (stage < ORDER_STAGE_KILLER_CM_QP)
-            stage = ORDER_STAGE_KILLER_CM_QP;
-          base += ORDER_THREAT_BONUS;
-        }
-      }
-
-      scores[i] = stage * ORDER_BUCKET + base;
-      ordered[i] = m;
-    }
-
-    sort_by_score_desc(scores, ordered, n);
+    const auto &board = pos.getBoard();
 
     const bool allowFutility = !inCheck && !isPV;
     int moveCount = 0;
@@ -1920,12 +2235,14 @@ namespace lilia::engine
     int searchedQuietCount = 0;
     int searchedCaptureCount = 0;
 
-    for (int idx = 0; idx < n; ++idx)
+    for (int idx = 0;; ++idx)
     {
       if ((idx & STOP_POLL_MASK) == 0)
         check_stop(stopFlag);
 
-      const chess::Move m = ordered[idx];
+      const chess::Move m = picker.next();
+      if (m.isNull())
+        break;
       if (excludedMove && m == *excludedMove)
       {
         continue; // don’t skew LMR/LMP with a non-searched move
@@ -2011,9 +2328,7 @@ namespace lilia::engine
       {
         int hist = history[m.from()][m.to()] + (quietHist[chess::bb::type_index(moverPt)][m.to()] >> QUIET_HIST_BLEND_SHIFT);
 
-        int ch = 0;
-        if (pm1_to >= 0 && pm1_pt >= 0)
-          ch = contHist[0][pm1_pt][pm1_to][chess::bb::type_index(moverPt)][m.to()];
+        const int ch = cont[0] ? cont[0]->h[0][chess::bb::type_index(moverPt)][m.to()] : 0;
 
         int limit = LMP_LIMIT[depth];
         if (hist < BAD_HISTORY_THRESHOLD)
@@ -2125,7 +2440,12 @@ namespace lilia::engine
                                            : moverPt;
 
       MoveUndoGuard g(pos);
-      if (!g.doMove(m))
+      if (picker.needs_legality_check())
+      {
+        if (!g.doMove(m))
+          continue; // TT move, killer or countermove that is illegal here
+      }
+      else if (!g.doLegalMove(m))
       {
         ++moveCount;
         continue;
@@ -2145,10 +2465,12 @@ namespace lilia::engine
         if (staticEval + capValPre + PROBCUT_MARGIN >= beta)
         {
           const int pcDepth = std::max(1, newDepth - PROBCUT_REDUCTION);
+          ++stats.counters.probCutTries;
           const int probe =
               -negamax(pos, pcDepth, -beta, -(beta - 1), ply + 1, childBest, -staticEval);
           if (probe >= beta)
           {
+            ++stats.counters.probCutCutoffs;
             if (!(stopFlag && stopFlag->load(std::memory_order_relaxed)))
               tt.store(nodeKey, encode_tt_score(probe, cap_ply(ply)),
                        static_cast<int16_t>(depth), Bound::Lower, m,
@@ -2220,9 +2542,7 @@ namespace lilia::engine
             r = std::max(0, r - 1);
           const int h = history[m.from()][m.to()] + (quietHist[chess::bb::type_index(moverPt)][m.to()] >> QUIET_HIST_BLEND_SHIFT);
 
-          int ch = 0;
-          if (pm1_to >= 0 && pm1_pt >= 0)
-            ch = contHist[0][pm1_pt][pm1_to][chess::bb::type_index(moverPt)][m.to()];
+          const int ch = cont[0] ? cont[0]->h[0][chess::bb::type_index(moverPt)][m.to()] : 0;
 
           if (h > LMR_GOOD_HISTORY_THRESHOLD)
             r -= 1;
@@ -2255,10 +2575,14 @@ namespace lilia::engine
           reduction = std::min(r, newDepth - 1);
         }
 
+        if (reduction > 0)
+          ++stats.counters.lmrReduced;
         value =
             -negamax(pos, newDepth - reduction, -alpha - 1, -alpha, ply + 1, childBest, -staticEval);
         if (value > alpha && value < beta)
         {
+          if (reduction > 0)
+            ++stats.counters.lmrResearches;
           value = -negamax(pos, newDepth, -beta, -alpha, ply + 1, childBest, -staticEval);
         }
       }
@@ -2274,12 +2598,9 @@ namespace lilia::engine
         hist_update(history[m.from()][m.to()], -M);
         hist_update(quietHist[chess::bb::type_index(moverPt)][m.to()], -M);
 
-        if (pm1_to >= 0 && pm1_pt >= 0)
-          hist_update(contHist[0][pm1_pt][pm1_to][chess::bb::type_index(moverPt)][m.to()], -M);
-        if (pm2_to >= 0 && pm2_pt >= 0)
-          hist_update(contHist[1][pm2_pt][pm2_to][chess::bb::type_index(moverPt)][m.to()], -(M >> CONTHIST_MALUS_SHIFT_L1));
-        if (pm3_to >= 0 && pm3_pt >= 0)
-          hist_update(contHist[2][pm3_pt][pm3_to][chess::bb::type_index(moverPt)][m.to()], -(M >> CONTHIST_MALUS_SHIFT_L2));
+        for (int l = 0; l < CONTHIST_LAYERS; ++l)
+          if (cont[l])
+            hist_update(cont[l]->h[l][chess::bb::type_index(moverPt)][m.to()], -(M >> CONTHIST_MALUS_SHIFT[l]));
       }
 
       if (value > best)
@@ -2292,14 +2613,15 @@ namespace lilia::engine
 
       if (alpha >= beta)
       {
+        ++stats.counters.betaCutoffs;
+        if (moveCount == 0)
+          ++stats.counters.firstMoveCutoffs;
         if (isQuiet)
-          reward_quiet_cutoff(*this, ply, depth, m, moverPt, prev, prevOk,
-                              pm1_to, pm2_to, pm3_to, pm1_pt, pm2_pt, pm3_pt);
+          reward_quiet_cutoff(*this, ply, depth, m, moverPt, prev, prevOk, cont);
         else if (m.isCapture())
           reward_capture_cutoff(*this, depth, moverPt, capPt, m.to());
 
-        penalize_preceding_quiets(*this, depth, searchedQuiets, searchedQuietCount,
-                                  pm1_to, pm2_to, pm3_to, pm1_pt, pm2_pt, pm3_pt);
+        penalize_preceding_quiets(*this, depth, searchedQuiets, searchedQuietCount, cont);
         penalize_preceding_captures(*this, depth, searchedCaptures, searchedCaptureCount);
         break;
       }
@@ -2315,11 +2637,11 @@ namespace lilia::engine
     // --- 5) Early ProbCut pass (cheap capture-only skim) ---
     if (!isPV && !inCheck && depth >= EARLY_PROBCUT_MIN_DEPTH)
     {
-      const int MAX_SCAN = std::min(n, EARLY_PROBCUT_MAX_SCAN);
+      const int MAX_SCAN = std::min(picker.yielded_count(), EARLY_PROBCUT_MAX_SCAN);
 
       for (int idx = 0; idx < MAX_SCAN; ++idx)
       {
-        const chess::Move m = ordered[idx];
+        const chess::Move m = picker.yielded(idx);
         if (!m.isCapture())
           continue;
         if (mvv_lva(pos.position(), m) < PROBCUT_MIN_MVV)
@@ -2329,14 +2651,19 @@ namespace lilia::engine
         if (!pcg.doMove(m))
           continue;
 
-        const int childSE = signed_eval(pos); // opponent POV
+        // only the side of the threshold matters, so the lazy path is enough
+        bool childExact = true;
+        const int childSE = signed_eval(pos, -(beta - EARLY_PROBCUT_MARGIN), -(beta - EARLY_PROBCUT_MARGIN) + 1,
+                                        childExact); // opponent POV
         if (-childSE + EARLY_PROBCUT_MARGIN >= beta)
         { // flip the sign
           chess::Move tmp{};
+          ++stats.counters.probCutTries;
           const int probe = -negamax(pos, depth - EARLY_PROBCUT_REDUCTION, -beta, -(beta - 1), ply + 1, tmp, INF);
           pcg.rollback();
           if (probe >= beta)
           {
+            ++stats.counters.probCutCutoffs;
             if (!(stopFlag && stopFlag->load(std::memory_order_relaxed)))
               tt.store(nodeKey, encode_tt_score(probe, cap_ply(ply)),
                        static_cast<int16_t>(depth), Bound::Lower, m,
@@ -2362,9 +2689,9 @@ namespace lilia::engine
     // safety: never leave node without searching at least one move (non-check)
     if (!searchedAny)
     {
-      for (int idx = 0; idx < n; ++idx)
+      for (int idx = 0; idx < picker.yielded_count(); ++idx)
       {
-        const chess::Move m = ordered[idx];
+        const chess::Move m = picker.yielded(idx);
         if (excludedMove && m == *excludedMove)
           continue;
         MoveUndoGuard g(pos);
@@ -2410,7 +2737,7 @@ namespace lilia::engine
     return best;
   }
 
-  std::vector<chess::Move> Search::build_pv_from_tt(SearchPosition pos, int max_len)
+  std::vector<chess::Move> Search::build_pv_from_tt(SearchPosition &pos, int max_len)
   {
     std::vector<chess::Move> pv;
     std::unordered_set<uint64_t> seen;
@@ -2435,6 +2762,9 @@ namespace lilia::engine
       if (!seen.insert(h).second)
         break; // loop guard
     }
+
+    for (std::size_t i = 0; i < pv.size(); ++i)
+      pos.undoMove();
     return pv;
   }
   int Search::search_root_single(SearchPosition &pos, int maxDepth,
@@ -2451,9 +2781,17 @@ namespace lilia::engine
     reset_node_batch();
 
     stats = SearchStats{};
+    // Helpers get a private or the shared pawn table from search_root_lazy_smp.
+    if (thread_id_ == 0)
+      eval_.setPawnHashSize(cfg.pawnHashMb);
+    eval_.setEvalHashSize(cfg.useEvalHash ? cfg.evalHashMb : 0);
+    eval_.resetEvalHashStats();
     auto t0 = steady_clock::now();
     auto update_time_stats = [&]
     {
+      const Evaluator::EvalHashStats eh = eval_.evalHashStats();
+      stats.counters.evalHashProbes = eh.probes;
+      stats.counters.evalHashHits = eh.hits;
       auto now = steady_clock::now();
       std::uint64_t ms =
           (std::uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - t0).count();
@@ -2464,22 +2802,7 @@ namespace lilia::engine
     try
     {
       std::vector<chess::Move> rootMoves;
-      mg.generatePseudoLegalMoves(pos.getBoard(), pos.getState(), rootMoves);
-      if (!rootMoves.empty())
-      {
-        std::vector<chess::Move> legalRoot;
-        legalRoot.reserve(rootMoves.size());
-        for (const auto &m : rootMoves)
-        {
-          MoveUndoGuard guard(pos);
-          if (guard.doMove(m))
-          {
-            legalRoot.push_back(m);
-            guard.rollback();
-          }
-        }
-        rootMoves.swap(legalRoot);
-      }
+      mg.generateLegalMoves(pos.getBoard(), pos.getState(), rootMoves);
       if (rootMoves.empty())
       {
         stats.nodes = flush_node_batch(sharedNodes);
@@ -2574,6 +2897,8 @@ namespace lilia::engine
       {
         if (stop && stop->load(std::memory_order_relaxed))
           break;
+        const std::uint64_t iterStartNodes = stats.counters.nodes + stats.counters.qnodes;
+        bool timeUp = false;
 
         if (depth > 1)
           decay_tables(*this, /*shift=*/HISTORY_DECAY_SHIFT);
@@ -2648,7 +2973,7 @@ namespace lilia::engine
             const chess::PieceType rootMovedPt = moved_piece_after(pos, m);
 
             MoveUndoGuard rg(pos);
-            if (!rg.doMove(m))
+            if (!rg.doLegalMove(m))
             {
               ++moveIdx;
               continue;
@@ -2751,7 +3076,7 @@ namespace lilia::engine
               const chess::PieceType rootMovedPt = moved_piece_after(pos, rl.m);
 
               MoveUndoGuard rg(pos);
-              if (!rg.doMove(rl.m))
+              if (!rg.doLegalMove(rl.m))
                 return;
 
               prevMove[0] = rl.m;
@@ -2836,15 +3161,13 @@ namespace lilia::engine
             prevBest = finalBest;
 
             stats.bestPV.clear();
+            if (pos.doMove(finalBest))
             {
-              SearchPosition tmp = pos;
-              if (tmp.doMove(finalBest))
-              {
-                stats.bestPV.push_back(finalBest);
-                auto rest = build_pv_from_tt(tmp, PV_FROM_TT_MAX_LEN);
-                for (auto &mv : rest)
-                  stats.bestPV.push_back(mv);
-              }
+              stats.bestPV.push_back(finalBest);
+              auto rest = build_pv_from_tt(pos, PV_FROM_TT_MAX_LEN);
+              for (auto &mv : rest)
+                stats.bestPV.push_back(mv);
+              pos.undoMove();
             }
 
             // build exact-only topMoves (best first)
@@ -2866,18 +3189,35 @@ namespace lilia::engine
                                { return a.second > b.second; });
             }
 
+            if (onInfo_ && thread_id_ == 0)
+            {
+              SearchInfo info;
+              info.depth = depth;
+              info.score = finalScore;
+              info.nodes = stats.nodes;
+              info.elapsedMs = stats.elapsedMs;
+              info.hashfull = tt.hashfull();
+              info.pv = stats.bestPV;
+              onInfo_(info);
+            }
+
+            if (tm_ && thread_id_ == 0)
+              timeUp = tm_->iteration_done(depth, finalBest, finalScore);
+
             break; // depth done
           }
 
           // widen window
           if (bestScore <= alphaTarget)
           {
+            ++stats.counters.aspFailLow;
             int step = std::max(ASPIRATION_WIDEN_MIN_STEP, window);
             alphaTarget = std::max(-INF + 1, alphaTarget - step);
             window += step / 2;
           }
           else if (bestScore >= betaTarget)
           {
+            ++stats.counters.aspFailHigh;
             int step = std::max(ASPIRATION_WIDEN_MIN_STEP, window);
             betaTarget = std::min(INF - 1, betaTarget + step);
             window += step / 2;
@@ -2888,7 +3228,10 @@ namespace lilia::engine
           }
         } // aspiration loop
 
-        if (is_mate_score(stats.bestScore))
+        stats.counters.depthNodes[std::min(depth, MAX_PLY)] =
+            stats.counters.nodes + stats.counters.qnodes - iterStartNodes;
+
+        if (timeUp || is_mate_score(stats.bestScore))
           break;
         lastScore = stats.bestScore;
       } // depth loop
@@ -2902,84 +3245,104 @@ namespace lilia::engine
     {
       // Ensure final stats are coherent on timeout/stop:
       stats.nodes = sharedNodes ? sharedNodes->load(std::memory_order_relaxed) : 0;
-      auto now = steady_clock::now();
-      std::uint64_t ms =
-          (std::uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - t0).count();
-      stats.elapsedMs = ms;
-      stats.nps = (ms ? (double)stats.nodes / (ms / 1000.0) : (double)stats.nodes);
+      update_time_stats();
       this->stopFlag.reset();
       return stats.bestScore; // return the last known best score
     }
   }
 
   int Search::search_root_lazy_smp(SearchPosition &pos, int maxDepth,
-                                   std::shared_ptr<std::atomic<bool>> stop, int maxThreads,
+                                   std::shared_ptr<std::atomic<bool>> stop,
+                                   std::vector<std::unique_ptr<Search>> &helpers, int maxThreads,
                                    std::uint64_t maxNodes)
   {
     tt.new_generation();
     const int threads = std::max(1, maxThreads > 0 ? std::min(maxThreads, cfg.threads) : cfg.threads);
+    eval_.setPawnHashSize(cfg.pawnHashMb);
 
+    // Fresh counter per search: Search objects outlive a single go now.
+    auto sharedCounter = std::make_shared<std::atomic<std::uint64_t>>(0);
     if (threads <= 1)
-      return search_root_single(pos, maxDepth, stop, maxNodes);
+    {
+      this->set_node_limit(sharedCounter, maxNodes);
+      const int score = search_root_single(pos, maxDepth, stop, maxNodes);
+      stats.threadCounters.assign(1, stats.counters);
+      return score;
+    }
 
     auto &pool = ThreadPool::instance();
-    auto sharedCounter = std::make_shared<std::atomic<std::uint64_t>>(0);
-    sharedCounter->store(0, std::memory_order_relaxed);
     const auto smpStart = steady_clock::now();
 
-    std::vector<std::unique_ptr<Search>> workers;
-    workers.reserve(threads);
-    for (int t = 0; t < threads; ++t)
+    const std::size_t helperCount = static_cast<std::size_t>(threads - 1);
+    if (helpers.size() > helperCount)
+      helpers.resize(helperCount);
+    while (helpers.size() < helperCount)
     {
       auto w = std::make_unique<Search>(tt, cfg);
-      w->set_thread_id(t);
-      w->stopFlag = stop;
-      w->set_node_limit(sharedCounter, maxNodes);
       w->copy_heuristics_from(*this);
-      workers.emplace_back(std::move(w));
+      helpers.emplace_back(std::move(w));
     }
-    for (auto &w : workers)
-      w->stopFlag = stop;
-    this->set_node_limit(sharedCounter, maxNodes);
 
-    int mainScore = 0;
-
-    const SearchPosition rootSnapshot = pos;
-
-    // start helper
-    std::vector<std::future<int>> futs;
-    futs.reserve(threads - 1);
-    for (int t = 1; t < threads; ++t)
+    for (std::size_t i = 0; i < helperCount; ++i)
     {
-      futs.emplace_back(pool.submit([rootSnapshot, &workers, maxDepth, stop, tid = t]
-                                    {
-      SearchPosition local = rootSnapshot;
-      return workers[tid]->search_root_single(local, maxDepth, stop, /*maxNodes*/ 0); }));
+      Search &w = *helpers[i];
+      w.set_thread_id(static_cast<int>(i + 1));
+      w.stopFlag = stop;
+      w.set_node_limit(sharedCounter, maxNodes);
+      if (cfg.sharedPawnHash)
+        w.eval_.sharePawnHash(eval_);
+      else
+        w.eval_.setPawnHashSize(cfg.pawnHashMb);
     }
+    this->set_node_limit(sharedCounter, maxNodes);
 
-    // Main search
-    mainScore = this->search_root_single(pos, maxDepth, stop, /*maxNodes*/ 0);
+    int mainScore = 0;
 
-    // Main is done stop helper
-    if (stop)
-      stop->store(true, std::memory_order_relaxed);
+    // Helpers rebuild their eval stacks from the bare position instead of copying pos's.
+    const chess::Position rootSnapshot = pos.position();
+
+    // Index 0 is the main search and runs on this thread (parallel_for keeps the
+    // leftmost index on the caller); the rest are helpers picked up by pool workers.
+    pool.parallel_for(0, static_cast<std::size_t>(threads), [&](std::size_t tid)
+                      {
+      if (tid == 0)
+      {
+        try
+        {
+          mainScore = this->search_root_single(pos, maxDepth, stop, /*maxNodes*/ 0);
+        }
+        catch (...)
+        {
+          if (stop)
+            stop->store(true, std::memory_order_relaxed);
+          throw;
+        }
+        // Main is done: stop the helpers
+        if (stop)
+          stop->store(true, std::memory_order_relaxed);
+        return;
+      }
 
-    // wait
-    for (auto &f : futs)
-    {
       try
       {
-        (void)f.get();
+        SearchPosition local(rootSnapshot);
+        (void)helpers[tid - 1]->search_root_single(local, maxDepth, stop, /*maxNodes*/ 0);
       }
       catch (...)
       {
-      }
-    }
+      } });
 
     // fold worker heuristics back into main
-    for (int t = 1; t < threads; ++t)
+    for (const auto &w : helpers)
+      this->merge_from(*w);
+
+    this->stats.threadCounters.clear();
+    this->stats.threadCounters.reserve(helpers.size() + 1);
+    this->stats.threadCounters.push_back(this->stats.counters);
+    for (const auto &w : helpers)
     {
-      this->merge_from(*workers[t]);
+      this->stats.threadCounters.push_back(w->stats.counters);
+      this->stats.counters += w->stats.counters;
     }
 
     // Finalize stats from all threads
@@ -3000,18 +3363,19 @@ namespace lilia::engine
       kk[0] = chess::Move{};
       kk[1] = chess::Move{};
     }
-    for (auto &h : history)
+    for (auto &h : history.v)
       h.fill(0);
     std::fill(&quietHist[0][0], &quietHist[0][0] + chess::PIECE_TYPE_NB * chess::SQ_NB, 0);
     std::fill(&captureHist[0][0][0], &captureHist[0][0][0] + chess::PIECE_TYPE_NB * chess::SQ_NB * chess::PIECE_TYPE_NB, 0);
     std::fill(&counterHist[0][0], &counterHist[0][0] + chess::SQ_NB * chess::SQ_NB, 0);
-    std::memset(contHist, 0, sizeof(contHist));
+    std::memset(contHist.v, 0, sizeof(contHist.v));
     for (auto &row : counterMove)
       for (auto &m : row)
         m = chess::Move{};
     for (auto &pm : prevMove)
       pm = chess::Move{};
     prevMovedPiece.fill(chess::PieceType::None);
+    eval_.clearCaches();
     stats = SearchStats{};
   }
 
@@ -3020,8 +3384,8 @@ namespace lilia::engine
     // History-like tables
     history = src.history;
 
-    std::memcpy(quietHist, src.quietHist, sizeof(quietHist));
-    std::memcpy(captureHist, src.captureHist, sizeof(captureHist));
+    std::memcpy(quietHist.v, src.quietHist.v, sizeof(quietHist.v));
+    std::memcpy(captureHist.v, src.captureHist.v, sizeof(captureHist.v));
     std::memcpy(counterHist, src.counterHist, sizeof(counterHist));
     std::memcpy(counterMove, src.counterMove, sizeof(counterMove));
     for (auto &kk : killers)
@@ -3076,13 +3440,13 @@ namespace lilia::engine
     }
 
     // Continuation History (EMA)
-    for (int L = 0; L < CONTHIST_LAYERS; ++L)
-      for (int pp = 0; pp < chess::PIECE_TYPE_NB; ++pp)
-        for (int pt = 0; pt < chess::SQ_NB; ++pt)
-          for (int mp = 0; mp < chess::PIECE_TYPE_NB; ++mp)
-            for (int to = 0; to < chess::SQ_NB; ++to)
-              contHist[L][pp][pt][mp][to] =
-                  ema_merge(contHist[L][pp][pt][mp][to], o.contHist[L][pp][pt][mp][to], K);
+    {
+      int16_t *dst = &contHist[0][0].h[0][0][0];
+      const int16_t *src = &o.contHist[0][0].h[0][0][0];
+      constexpr std::size_t N = sizeof(contHist.v) / sizeof(int16_t);
+      for (std::size_t i = 0; i < N; ++i)
+        dst[i] = ema_merge(dst[i], src[i], K);
+    }
   }
 
 }
@@ -33,6 +33,16 @@ namespace lilia::engine
       eval.move_piece(us, chess::PieceType::Rook, int(st.rookFrom), int(st.rookTo));
   }
 
+  void SearchPosition::init_eval()
+  {
+    m_stack[0].eval.build_from_board(m_pos.getBoard());
+    if (nnue::active())
+    {
+      m_nnue.resize(STACK_CAP);
+      nnue::refresh(m_nnue[0], m_pos.getBoard());
+    }
+  }
+
   bool SearchPosition::doMove(const chess::Move &m)
   {
     if (LILIA_UNLIKELY(m_ply + 1 >= STACK_CAP))
@@ -45,6 +55,25 @@ namespace lilia::engine
       return false;
 
     applyEvalDelta(next.st, next.eval);
+    if (!m_nnue.empty())
+      nnue::update(m_nnue[m_ply + 1], m_nnue[m_ply], next.st, m_pos.getBoard());
+    ++m_ply;
+    return true;
+  }
+
+  bool SearchPosition::doLegalMove(const chess::Move &m)
+  {
+    if (LILIA_UNLIKELY(m_ply + 1 >= STACK_CAP))
+      return false;
+
+    StackEntry &next = m_stack[m_ply + 1];
+    next.eval = m_stack[m_ply].eval;
+
+    m_pos.doLegalMove(m, next.st);
+
+    applyEvalDelta(next.st, next.eval);
+    if (!m_nnue.empty())
+      nnue::update(m_nnue[m_ply + 1], m_nnue[m_ply], next.st, m_pos.getBoard());
     ++m_ply;
     return true;
   }
@@ -69,6 +98,8 @@ namespace lilia::engine
     if (!m_pos.doNullMove(next.st))
       return false;
 
+    if (!m_nnue.empty())
+      m_nnue[m_ply + 1] = m_nnue[m_ply];
     ++m_ply;
     return true;
   }
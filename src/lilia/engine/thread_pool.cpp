@@ -0,0 +1,356 @@
+#include "lilia/engine/thread_pool.hpp"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace lilia::engine
+{
+  namespace
+  {
+    // Rounds of failed stealing before an idle thread goes to sleep.
+    constexpr int IDLE_SPINS = 256;
+
+    // Index of the pool worker running on this thread, -1 for outside threads.
+    thread_local int tlsWorker = -1;
+    thread_local std::uint32_t tlsRng = 0x9E3779B9u;
+
+    inline void cpu_relax() noexcept
+    {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+      _mm_pause();
+#else
+      std::this_thread::yield();
+#endif
+    }
+
+    inline std::uint32_t next_rand() noexcept
+    {
+      std::uint32_t x = tlsRng;
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      return tlsRng = x;
+    }
+  }
+
+  // ---------------- Chase-Lev deque ----------------
+
+  void ThreadPool::Deque::store(Slot &s, const Task &t) noexcept
+  {
+    s.run.store(t.run, std::memory_order_relaxed);
+    s.ctx.store(t.ctx, std::memory_order_relaxed);
+    s.begin.store(t.begin, std::memory_order_relaxed);
+    s.end.store(t.end, std::memory_order_relaxed);
+  }
+
+  ThreadPool::Task ThreadPool::Deque::load(const Slot &s) noexcept
+  {
+    return Task{s.run.load(std::memory_order_relaxed), s.ctx.load(std::memory_order_relaxed),
+                s.begin.load(std::memory_order_relaxed), s.end.load(std::memory_order_relaxed)};
+  }
+
+  bool ThreadPool::Deque::push(const Task &t) noexcept
+  {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t top = top_.load(std::memory_order_acquire);
+    if (b - top >= CAP)
+      return false;
+
+    store(slots_[static_cast<std::size_t>(b & (CAP - 1))], t);
+    bottom_.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool ThreadPool::Deque::pop(Task &out) noexcept
+  {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = top_.load(std::memory_order_relaxed);
+
+    if (top > b)
+    {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    out = load(slots_[static_cast<std::size_t>(b & (CAP - 1))]);
+    if (top == b)
+    {
+      // last element: race the thieves for it
+      const bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  bool ThreadPool::Deque::steal(Task &out) noexcept
+  {
+    std::int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t b = bottom_.load(std::memory_order_acquire);
+    if (top >= b)
+      return false;
+
+    out = load(slots_[static_cast<std::size_t>(top & (CAP - 1))]);
+    return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed);
+  }
+
+  // ---------------- injector ----------------
+
+  ThreadPool::Injector::Injector() noexcept
+  {
+    for (std::size_t i = 0; i < CAP; ++i)
+      cells_[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  bool ThreadPool::Injector::push(const Task &t) noexcept
+  {
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      Cell &c = cells_[pos & (CAP - 1)];
+      const std::size_t seq = c.seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0)
+      {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          c.task = t;
+          c.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false; // full
+      }
+      else
+      {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool ThreadPool::Injector::pop(Task &out) noexcept
+  {
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      Cell &c = cells_[pos & (CAP - 1)];
+      const std::size_t seq = c.seq.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+      if (diff == 0)
+      {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          out = c.task;
+          c.seq.store(pos + CAP, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false; // empty
+      }
+      else
+      {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // ---------------- pool ----------------
+
+  ThreadPool::ThreadPool(int desired_threads)
+  {
+    int n = desired_threads > 0 ? desired_threads : (int)std::thread::hardware_concurrency();
+    maybe_resize(n > 0 ? n : 1);
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    stop_.store(true, std::memory_order_seq_cst);
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    epoch_.notify_all();
+
+    const std::size_t n = count_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < n; ++i)
+      if (workers_[i]->thread.joinable())
+        workers_[i]->thread.join();
+  }
+
+  void ThreadPool::maybe_resize(int desired)
+  {
+    if (desired <= 0)
+      return;
+
+    std::lock_guard<std::mutex> lk(growMutex_);
+    const std::size_t want = std::min<std::size_t>(static_cast<std::size_t>(desired), MAX_WORKERS);
+    for (std::size_t i = count_.load(std::memory_order_relaxed); i < want && !stop_.load(); ++i)
+    {
+      workers_[i] = std::make_unique<Worker>();
+      // publish the deque before the thread (or any thief) can look at it
+      count_.store(i + 1, std::memory_order_release);
+      workers_[i]->thread = std::thread([this, i]
+                                        { worker_main(i); });
+    }
+  }
+
+  void ThreadPool::set_pinning(bool on)
+  {
+    std::lock_guard<std::mutex> lk(growMutex_);
+    if (pinned_.exchange(on) == on)
+      return;
+    const std::size_t n = count_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < n; ++i)
+      apply_pinning(i);
+  }
+
+  void ThreadPool::apply_pinning(std::size_t index) noexcept
+  {
+    pin_thread(workers_[index]->thread.native_handle(), index);
+  }
+
+  void ThreadPool::pin_thread(std::thread::native_handle_type handle, std::size_t index) noexcept
+  {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pinned_.load(std::memory_order_relaxed))
+    {
+      const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+      CPU_SET(static_cast<int>((index + 1) % hw), &set);
+    }
+    else if (::sched_getaffinity(0, sizeof(set), &set) != 0)
+    {
+      return;
+    }
+    (void)::pthread_setaffinity_np(handle, sizeof(set), &set);
+#else
+    (void)handle;
+    (void)index;
+#endif
+  }
+
+  bool ThreadPool::push(const Task &t) noexcept
+  {
+    const bool ok = tlsWorker >= 0 ? workers_[static_cast<std::size_t>(tlsWorker)]->deque.push(t)
+                                   : injector_.push(t);
+    if (ok)
+      signal();
+    return ok;
+  }
+
+  void ThreadPool::signal() noexcept
+  {
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0)
+      epoch_.notify_all();
+  }
+
+  bool ThreadPool::find_task(Task &out) noexcept
+  {
+    if (tlsWorker >= 0 && workers_[static_cast<std::size_t>(tlsWorker)]->deque.pop(out))
+      return true;
+    if (injector_.pop(out))
+      return true;
+
+    const std::size_t n = count_.load(std::memory_order_acquire);
+    if (n == 0)
+      return false;
+    const std::size_t start = next_rand() % n;
+    for (std::size_t k = 0; k < n; ++k)
+    {
+      const std::size_t v = (start + k) % n;
+      if (static_cast<int>(v) != tlsWorker && workers_[v]->deque.steal(out))
+        return true;
+    }
+    return false;
+  }
+
+  void ThreadPool::help_until(const std::atomic<std::size_t> &pending) noexcept
+  {
+    int idle = 0;
+    while (pending.load(std::memory_order_acquire) != 0)
+    {
+      Task t;
+      if (find_task(t))
+      {
+        t.run(t.ctx, t.begin, t.end);
+        idle = 0;
+        continue;
+      }
+      if (++idle < IDLE_SPINS)
+      {
+        cpu_relax();
+        continue;
+      }
+
+      // Sleep until something is pushed or a range completes.
+      sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      const std::uint32_t e = epoch_.load(std::memory_order_seq_cst);
+      if (pending.load(std::memory_order_acquire) != 0)
+      {
+        if (find_task(t))
+          t.run(t.ctx, t.begin, t.end);
+        else
+          epoch_.wait(e, std::memory_order_seq_cst);
+      }
+      sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+      idle = 0;
+    }
+  }
+
+  void ThreadPool::worker_main(std::size_t index)
+  {
+    tlsWorker = static_cast<int>(index);
+    tlsRng ^= static_cast<std::uint32_t>(index + 1) * 0x85EBCA6Bu;
+#if defined(__linux__)
+    // own handle: workers_[index]->thread may not be assigned yet
+    if (pinned_.load(std::memory_order_relaxed))
+      pin_thread(::pthread_self(), index);
+#endif
+
+    int idle = 0;
+    while (!stop_.load(std::memory_order_relaxed))
+    {
+      Task t;
+      if (find_task(t))
+      {
+        t.run(t.ctx, t.begin, t.end);
+        idle = 0;
+        continue;
+      }
+      if (++idle < IDLE_SPINS)
+      {
+        cpu_relax();
+        continue;
+      }
+
+      sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      const std::uint32_t e = epoch_.load(std::memory_order_seq_cst);
+      if (!stop_.load(std::memory_order_seq_cst))
+      {
+        if (find_task(t))
+          t.run(t.ctx, t.begin, t.end);
+        else
+          epoch_.wait(e, std::memory_order_seq_cst);
+      }
+      sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+      idle = 0;
+    }
+  }
+
+}
@@ -0,0 +1,114 @@
+#include "lilia/engine/time_manager.hpp"
+
+#include <algorithm>
+
+namespace lilia::engine
+{
+  namespace
+  {
+    constexpr int DEFAULT_MOVES_TO_GO = 30;
+    constexpr int MAX_MOVES_TO_GO = 50;
+
+    // hard = min(HARD_SOFT_RATIO * soft, HARD_TIME_PCT% of the clock + inc, HARD_MAX_PCT% of
+    // the clock); the last cap holds however large the increment is.
+    constexpr int HARD_SOFT_RATIO = 4;
+    constexpr int HARD_TIME_PCT = 30;
+    constexpr int HARD_MAX_PCT = 75;
+    // soft spends INC_USE_PCT% of the increment, but never more than INC_MAX_LEFT_PCT% of the clock
+    constexpr int INC_USE_PCT = 75;
+    constexpr int INC_MAX_LEFT_PCT = 50;
+
+    // No early stop before this depth; shallow iterations say little about stability.
+    constexpr int STABILITY_MIN_DEPTH = 5;
+
+    // soft scale by number of iterations the best move has not changed (last entry repeats)
+    constexpr double STABILITY_SCALE[] = {1.40, 1.10, 0.95, 0.85, 0.75, 0.65, 0.55};
+    constexpr int STABILITY_STEPS = static_cast<int>(sizeof(STABILITY_SCALE) / sizeof(STABILITY_SCALE[0]));
+
+    // score drop (cp) that earns the full SCORE_DROP_MAX_EXTRA extension
+    constexpr int SCORE_DROP_FULL = 100;
+    constexpr double SCORE_DROP_MAX_EXTRA = 0.8;
+
+    // Starting another iteration costs roughly the branching factor; stop once this much
+    // of the adjusted budget is used.
+    constexpr double NEXT_ITERATION_FRACTION = 0.6;
+  }
+
+  void TimeManager::start(const TimeLimits &lim)
+  {
+    start_ = clock::now();
+    active_ = false;
+    fixed_ = false;
+    hardDeadline_ = clock::time_point::max();
+    softMs_ = hardMs_ = 0;
+    lastBest_ = chess::Move{};
+    lastScore_ = 0;
+    stableIters_ = 0;
+    haveLast_ = false;
+
+    const int overhead = std::max(0, lim.overhead);
+
+    if (lim.moveTime > 0)
+    {
+      fixed_ = true;
+      softMs_ = hardMs_ = std::max(1, lim.moveTime - overhead);
+    }
+    else if (lim.time >= 0)
+    {
+      const std::int64_t left = std::max(1, lim.time - overhead);
+      const std::int64_t mtg =
+          lim.movesToGo > 0 ? std::min(lim.movesToGo, MAX_MOVES_TO_GO) : DEFAULT_MOVES_TO_GO;
+      const std::int64_t inc = std::max(0, lim.inc);
+
+      const std::int64_t incShare = std::min(inc * INC_USE_PCT / 100, left * INC_MAX_LEFT_PCT / 100);
+      const std::int64_t soft = left / mtg + incShare;
+      const std::int64_t hard = std::min({soft * HARD_SOFT_RATIO, left * HARD_TIME_PCT / 100 + inc,
+                                          left * HARD_MAX_PCT / 100});
+
+      hardMs_ = std::clamp<std::int64_t>(hard, 1, left);
+      softMs_ = std::clamp<std::int64_t>(soft, 1, hardMs_);
+    }
+    else
+    {
+      return; // depth/nodes/infinite: no clock
+    }
+
+    active_ = true;
+    hardDeadline_ = start_ + std::chrono::milliseconds(hardMs_);
+  }
+
+  std::int64_t TimeManager::elapsed_ms() const noexcept
+  {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start_).count();
+  }
+
+  bool TimeManager::iteration_done(int depth, chess::Move best, int score) noexcept
+  {
+    const bool changed = !haveLast_ || !(best == lastBest_);
+    const int drop = haveLast_ ? lastScore_ - score : 0;
+
+    stableIters_ = changed ? 0 : stableIters_ + 1;
+    lastBest_ = best;
+    lastScore_ = score;
+    haveLast_ = true;
+
+    if (!active_)
+      return false;
+    if (fixed_)
+      return elapsed_ms() >= hardMs_;
+
+    const std::int64_t elapsed = elapsed_ms();
+    if (elapsed >= hardMs_)
+      return true;
+    if (depth < STABILITY_MIN_DEPTH)
+      return elapsed >= softMs_;
+
+    double scale = STABILITY_SCALE[std::min(stableIters_, STABILITY_STEPS - 1)];
+    if (drop > 0)
+      scale *= 1.0 + SCORE_DROP_MAX_EXTRA * std::min(drop, SCORE_DROP_FULL) / SCORE_DROP_FULL;
+
+    const double target = std::min<double>(static_cast<double>(softMs_) * scale, static_cast<double>(hardMs_));
+    return static_cast<double>(elapsed) >= target * NEXT_ITERATION_FRACTION;
+  }
+
+}
@@ -0,0 +1,437 @@
+#include "lilia/engine/transposition_table.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+#include "lilia/chess/zobrist.hpp"
+#include "lilia/engine/thread_pool.hpp"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lilia::engine
+{
+  namespace
+  {
+    constexpr std::size_t MB = 1024ull * 1024ull;
+    constexpr std::size_t PAGE_2M = 2 * MB;
+    constexpr std::size_t PAGE_1G = 1024 * MB;
+    constexpr std::size_t CLUSTER_ALIGN = 64;
+
+    // Below this a single memset is faster than waking the pool.
+    constexpr std::size_t PARALLEL_CLEAR_MIN_BYTES = 64 * MB;
+
+    LILIA_ALWAYS_INLINE std::size_t round_up(std::size_t v, std::size_t a)
+    {
+      return (v + a - 1) / a * a;
+    }
+
+    // On-disk TT image: this header, then the clusters verbatim. Padded to a cluster so
+    // the payload stays 64-byte aligned inside a mapping of the file.
+    constexpr char TT_FILE_MAGIC[8] = {'L', 'I', 'L', 'T', 'T', 'F', 'I', 'L'};
+    constexpr std::uint32_t TT_FILE_VERSION = 1;
+
+    struct TTFileHeader
+    {
+      char magic[8];
+      std::uint32_t version;
+      std::uint32_t clusterBytes;
+      std::uint64_t clusterCount;
+      std::uint64_t zobristSeed;
+      std::uint8_t generation;
+      std::uint8_t pad[CLUSTER_ALIGN - 33];
+    };
+    static_assert(sizeof(TTFileHeader) == CLUSTER_ALIGN);
+
+    // Splits [0, bytes) into 2 MB granular chunks (no huge page shared between
+    // threads) and runs fn(off, len) on the pool; small ranges stay on the caller.
+    template <class Fn>
+    void for_each_chunk_parallel(std::size_t bytes, Fn fn) noexcept
+    {
+      const std::size_t workers = bytes >= PARALLEL_CLEAR_MIN_BYTES ? ThreadPool::instance().size() + 1 : 1;
+      if (workers <= 1)
+      {
+        fn(std::size_t{0}, bytes);
+        return;
+      }
+
+      const std::size_t chunk = round_up((bytes + workers - 1) / workers, PAGE_2M);
+      const std::size_t chunks = (bytes + chunk - 1) / chunk;
+
+      try
+      {
+        ThreadPool::instance().parallel_for(0, chunks, [&](std::size_t i)
+                                            {
+          const std::size_t off = i * chunk;
+          fn(off, std::min(chunk, bytes - off)); });
+      }
+      catch (...)
+      {
+        fn(std::size_t{0}, bytes);
+      }
+    }
+
+    struct RawAlloc
+    {
+      void *ptr = nullptr;
+      TTPageMode mode = TTPageMode::Normal;
+    };
+
+#if defined(__linux__)
+    void *map_hugetlb(std::size_t bytes, int pageShift)
+    {
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+      void *p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (pageShift << MAP_HUGE_SHIFT), -1, 0);
+      return p == MAP_FAILED ? nullptr : p;
+#else
+      (void)bytes;
+      (void)pageShift;
+      return nullptr;
+#endif
+    }
+#endif
+
+    RawAlloc allocate(std::size_t bytes, TTPagePolicy policy)
+    {
+#if defined(__linux__)
+      if (policy == TTPagePolicy::HugeTLB)
+      {
+        if (bytes >= PAGE_1G)
+          if (void *p = map_hugetlb(round_up(bytes, PAGE_1G), 30))
+            return {p, TTPageMode::Huge1G};
+        if (void *p = map_hugetlb(round_up(bytes, PAGE_2M), 21))
+          return {p, TTPageMode::Huge2M};
+      }
+
+      if (policy != TTPagePolicy::Off)
+      {
+        if (void *p = std::aligned_alloc(PAGE_2M, round_up(bytes, PAGE_2M)))
+        {
+#if defined(MADV_HUGEPAGE)
+          if (::madvise(p, round_up(bytes, PAGE_2M), MADV_HUGEPAGE) == 0)
+            return {p, TTPageMode::Transparent};
+#endif
+          std::free(p);
+        }
+      }
+#else
+      (void)policy;
+#endif
+      return {::operator new(bytes, std::align_val_t{CLUSTER_ALIGN}, std::nothrow), TTPageMode::Normal};
+    }
+
+    bool header_matches(const TTFileHeader &h, std::size_t clusterBytes) noexcept
+    {
+      return std::memcmp(h.magic, TT_FILE_MAGIC, sizeof(h.magic)) == 0 && h.version == TT_FILE_VERSION &&
+             h.clusterBytes == clusterBytes && h.zobristSeed == chess::Zobrist::seed;
+    }
+
+#if defined(__linux__)
+    // Maps (creating if needed) the POSIX shm segment `name`: a TTFileHeader, then the
+    // clusters. The creator sizes the segment (zero-filled by the kernel) and publishes the
+    // header, magic last. Anyone else attaches only if the header describes exactly this
+    // table; a segment still being created reads as a mismatch.
+    TTFileHeader *map_shared(const std::string &name, std::uint64_t clusterCount, std::size_t clusterBytes)
+    {
+      const std::string shmName = (!name.empty() && name.front() == '/') ? name : "/" + name;
+      const std::size_t bytes = sizeof(TTFileHeader) + clusterCount * clusterBytes;
+
+      bool created = true;
+      int fd = ::shm_open(shmName.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+      if (fd < 0 && errno == EEXIST)
+      {
+        created = false;
+        fd = ::shm_open(shmName.c_str(), O_RDWR | O_CLOEXEC, 0600);
+      }
+      if (fd < 0)
+        return nullptr;
+
+      struct stat st{};
+      const bool sizeOk = created ? ::ftruncate(fd, static_cast<off_t>(bytes)) == 0
+                                  : ::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) == bytes;
+
+      void *p = sizeOk ? ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+      ::close(fd);
+      if (p == MAP_FAILED)
+      {
+        if (created)
+          ::shm_unlink(shmName.c_str());
+        return nullptr;
+      }
+
+      auto *h = static_cast<TTFileHeader *>(p);
+      if (created)
+      {
+        h->version = TT_FILE_VERSION;
+        h->clusterBytes = static_cast<std::uint32_t>(clusterBytes);
+        h->clusterCount = clusterCount;
+        h->zobristSeed = chess::Zobrist::seed;
+        h->generation = 0u;
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(h->magic, TT_FILE_MAGIC, sizeof(h->magic));
+        return h;
+      }
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (!header_matches(*h, clusterBytes) || h->clusterCount != clusterCount)
+      {
+        ::munmap(p, bytes);
+        return nullptr;
+      }
+      return h;
+    }
+#endif
+
+    void deallocate(void *p, std::size_t bytes, TTPageMode mode) noexcept
+    {
+      if (!p)
+        return;
+
+      switch (mode)
+      {
+#if defined(__linux__)
+      case TTPageMode::Huge1G:
+        ::munmap(p, round_up(bytes, PAGE_1G));
+        return;
+      case TTPageMode::Huge2M:
+        ::munmap(p, round_up(bytes, PAGE_2M));
+        return;
+      case TTPageMode::Shared:
+        ::munmap(static_cast<unsigned char *>(p) - sizeof(TTFileHeader), sizeof(TTFileHeader) + bytes);
+        return;
+      case TTPageMode::Transparent:
+        std::free(p);
+        return;
+#endif
+      default:
+        ::operator delete(p, std::align_val_t{CLUSTER_ALIGN});
+        return;
+      }
+    }
+  }
+
+  const char *tt_page_mode_name(TTPageMode m) noexcept
+  {
+    switch (m)
+    {
+    case TTPageMode::Transparent:
+      return "transparent huge pages";
+    case TTPageMode::Huge2M:
+      return "2 MB huge pages";
+    case TTPageMode::Huge1G:
+      return "1 GB huge pages";
+    case TTPageMode::Shared:
+      return "shared memory";
+    case TTPageMode::Normal:
+    default:
+      return "normal pages";
+    }
+  }
+
+  TT::~TT()
+  {
+    release();
+  }
+
+  void TT::release() noexcept
+  {
+    deallocate(table_, allocBytes_, pageMode_);
+    table_ = nullptr;
+    allocBytes_ = 0;
+    pageMode_ = TTPageMode::Normal;
+    generation_ = &ownGeneration_;
+  }
+
+  void TT::resize(std::size_t mb, TTPagePolicy pages, const std::string &sharedName)
+  {
+    // The old table is released only once the new one exists: a failed allocation
+    // throws with the engine still holding its current table.
+    const std::size_t bytes = std::max<std::size_t>(mb, 1) * MB;
+    const std::size_t clusters = std::max<std::size_t>(1, bytes / sizeof(Cluster));
+    const std::size_t allocBytes = clusters * sizeof(Cluster);
+
+    auto adopt = [&](void *p, TTPageMode mode)
+    {
+      release();
+      table_ = static_cast<Cluster *>(p);
+      clusterCount_ = clusters;
+      allocBytes_ = allocBytes;
+      pageMode_ = mode;
+    };
+
+#if defined(__linux__)
+    if (!sharedName.empty())
+    {
+      if (TTFileHeader *h = map_shared(sharedName, clusters, sizeof(Cluster)))
+      {
+        // Keep whatever the other processes already stored, generation included.
+        adopt(h + 1, TTPageMode::Shared);
+        generation_ = &h->generation;
+        return;
+      }
+    }
+#endif
+
+    const RawAlloc a = allocate(allocBytes, pages);
+    if (!a.ptr)
+      throw std::bad_alloc();
+
+    adopt(a.ptr, a.mode);
+    clear();
+  }
+
+  int TT::hashfull() const noexcept
+  {
+    if (!table_)
+      return 0;
+
+    // 250 clusters x 4 slots = 1000 samples, so the count is already in permille.
+    // Same age store() stamps: generation 0 is written as 1.
+    const std::uint8_t gen = current_generation();
+    const std::size_t sample = std::min<std::size_t>(clusterCount_, 250);
+    int used = 0;
+    for (std::size_t i = 0; i < sample; ++i)
+      for (const auto &s : table_[i].slot)
+      {
+        const std::uint64_t m = s.meta;
+        used += (m & META_VALID_MASK) && meta_age(m) == gen;
+      }
+    return static_cast<int>(used * 1000 / (sample * ClusterSize));
+  }
+
+  void TT::clear() noexcept
+  {
+    if (!table_)
+      return;
+
+    zero_parallel();
+    std::atomic_ref<std::uint8_t>(*generation_).store(0u, std::memory_order_relaxed);
+  }
+
+  void TT::zero_parallel() noexcept
+  {
+    auto *base = reinterpret_cast<unsigned char *>(table_);
+    for_each_chunk_parallel(clusterCount_ * sizeof(Cluster), [base](std::size_t off, std::size_t len)
+                            { std::memset(base + off, 0, len); });
+  }
+
+  void TT::copy_parallel(const void *src) noexcept
+  {
+    auto *base = reinterpret_cast<unsigned char *>(table_);
+    const auto *from = static_cast<const unsigned char *>(src);
+    for_each_chunk_parallel(clusterCount_ * sizeof(Cluster), [base, from](std::size_t off, std::size_t len)
+                            { std::memcpy(base + off, from + off, len); });
+  }
+
+  bool TT::save(const std::string &path) const
+  {
+    if (!table_)
+      return false;
+
+    TTFileHeader h{};
+    std::memcpy(h.magic, TT_FILE_MAGIC, sizeof(h.magic));
+    h.version = TT_FILE_VERSION;
+    h.clusterBytes = static_cast<std::uint32_t>(sizeof(Cluster));
+    h.clusterCount = clusterCount_;
+    h.zobristSeed = chess::Zobrist::seed;
+    h.generation = generation();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+    out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char *>(table_), static_cast<std::streamsize>(clusterCount_ * sizeof(Cluster)));
+    out.flush();
+    return static_cast<bool>(out);
+  }
+
+  bool TT::load(const std::string &path, TTPagePolicy pages)
+  {
+    if (is_shared())
+      return false;
+
+    auto compatible = [](const TTFileHeader &h, std::uint64_t fileBytes)
+    {
+      return header_matches(h, sizeof(Cluster)) && h.clusterCount > 0 && (h.clusterCount * sizeof(Cluster)) % MB == 0 &&
+             fileBytes == sizeof(TTFileHeader) + h.clusterCount * sizeof(Cluster);
+    };
+
+#if defined(__linux__)
+    // Map the image and copy it in on the pool; pages land on the nodes that will
+    // use them, same as a cleared table.
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return false;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || static_cast<std::uint64_t>(st.st_size) < sizeof(TTFileHeader))
+    {
+      ::close(fd);
+      return false;
+    }
+
+    const std::size_t fileBytes = static_cast<std::size_t>(st.st_size);
+    void *map = ::mmap(nullptr, fileBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+      return false;
+
+    TTFileHeader h;
+    std::memcpy(&h, map, sizeof(h));
+    if (!compatible(h, fileBytes))
+    {
+      ::munmap(map, fileBytes);
+      return false;
+    }
+
+    ::madvise(map, fileBytes, MADV_SEQUENTIAL);
+
+    try
+    {
+      if (h.clusterCount != clusterCount_ || !table_)
+        resize(h.clusterCount * sizeof(Cluster) / MB, pages);
+    }
+    catch (...)
+    {
+      ::munmap(map, fileBytes);
+      throw;
+    }
+
+    copy_parallel(static_cast<const unsigned char *>(map) + sizeof(TTFileHeader));
+    ::munmap(map, fileBytes);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+      return false;
+    const std::uint64_t fileBytes = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+
+    TTFileHeader h;
+    if (!in.read(reinterpret_cast<char *>(&h), sizeof(h)) || !compatible(h, fileBytes))
+      return false;
+
+    if (h.clusterCount != clusterCount_ || !table_)
+      resize(h.clusterCount * sizeof(Cluster) / MB, pages);
+
+    if (!in.read(reinterpret_cast<char *>(table_), static_cast<std::streamsize>(clusterCount_ * sizeof(Cluster))))
+    {
+      clear();
+      return false;
+    }
+#endif
+
+    ownGeneration_ = h.generation;
+    return true;
+  }
+
+}
@@ -5,8 +5,12 @@
 #include <atomic>
 #include <cctype>
 #include <charconv>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <iomanip>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -14,7 +18,10 @@
 #include <thread>
 #include <utility>
 
+#include "lilia/engine/bench.hpp"
 #include "lilia/engine/bot_engine.hpp"
+#include "lilia/engine/nnue.hpp"
+#include "lilia/engine/perft.hpp"
 #include "lilia/chess/chess_game.hpp"
 #include "lilia/protocol/uci/uci_helper.hpp"
 #include "lilia/chess/chess_constants.hpp"
@@ -142,6 +149,150 @@ namespace lilia::protocol::uci
       return out;
     }
 
+    // Iterations finishing closer together than this are coalesced; the last one is always shown.
+    constexpr auto INFO_MIN_INTERVAL = std::chrono::milliseconds(50);
+
+    static std::string format_info(const engine::SearchInfo &in)
+    {
+      std::ostringstream oss;
+      oss << "info depth " << in.depth << " score ";
+      if (std::abs(in.score) >= engine::MATE_THR)
+      {
+        const int plies = engine::MATE - std::abs(in.score);
+        const int moves = (plies + 1) / 2;
+        oss << "mate " << (in.score > 0 ? moves : -moves);
+      }
+      else
+      {
+        oss << "cp " << in.score;
+      }
+      oss << " nodes " << in.nodes << " nps " << (in.elapsedMs ? in.nodes * 1000 / in.elapsedMs : in.nodes)
+          << " hashfull " << in.hashfull << " time " << in.elapsedMs;
+      if (!in.pv.empty())
+      {
+        oss << " pv";
+        for (const auto &m : in.pv)
+          oss << ' ' << uci::move_to_uci(m);
+      }
+      oss << "\n";
+      return oss.str();
+    }
+
+    // Rate limiter for info lines; only touched by the thread running the main search.
+    struct InfoStream
+    {
+      std::chrono::steady_clock::time_point last{};
+      std::string pending;
+
+      void on_iteration(const engine::SearchInfo &in)
+      {
+        pending = format_info(in);
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last >= INFO_MIN_INTERVAL)
+        {
+          last = now;
+          flush();
+        }
+      }
+
+      void flush()
+      {
+        if (pending.empty())
+          return;
+        std::cout << pending;
+        std::cout.flush();
+        pending.clear();
+      }
+    };
+
+    static inline double pct(std::uint64_t num, std::uint64_t den) noexcept
+    {
+      return den ? 100.0 * static_cast<double>(num) / static_cast<double>(den) : 0.0;
+    }
+
+    static void append_counters(std::ostringstream &oss, const engine::SearchCounters &c,
+                                std::uint64_t elapsedMs)
+    {
+      const std::uint64_t all = c.nodes + c.qnodes;
+      const std::uint64_t ttHits = c.ttHits[0] + c.ttHits[1] + c.ttHits[2] + c.ttHits[3];
+
+      oss << " nodes " << all << " nps " << (elapsedMs ? all * 1000 / elapsedMs : all)
+          << " qnodes% " << pct(c.qnodes, all)
+          << " tthit% " << pct(ttHits, c.ttProbes)
+          << " (exact " << pct(c.ttHits[static_cast<int>(engine::Bound::Exact)], c.ttProbes)
+          << " lower " << pct(c.ttHits[static_cast<int>(engine::Bound::Lower)], c.ttProbes)
+          << " upper " << pct(c.ttHits[static_cast<int>(engine::Bound::Upper)], c.ttProbes) << ")"
+          << " firstcut% " << pct(c.firstMoveCutoffs, c.betaCutoffs)
+          << " null " << c.nullTries << " cut% " << pct(c.nullCutoffs, c.nullTries)
+          << " verifyfail " << c.nullVerifyFails
+          << " probcut " << c.probCutTries << " cut% " << pct(c.probCutCutoffs, c.probCutTries)
+          << " lmr " << c.lmrReduced << " research% " << pct(c.lmrResearches, c.lmrReduced)
+          << " asp fh " << c.aspFailHigh << " fl " << c.aspFailLow
+          << " evalhash% " << pct(c.evalHashHits, c.evalHashProbes);
+    }
+
+    // Search-health report as info strings: aggregate, per thread, then the effective
+    // branching factor of each completed iteration.
+    static void print_search_stats(const engine::SearchStats &st)
+    {
+      std::ostringstream oss;
+      oss.setf(std::ios::fixed);
+      oss.precision(1);
+
+      oss << "info string stats total";
+      append_counters(oss, st.counters, st.elapsedMs);
+      oss << "\n";
+
+      if (st.threadCounters.size() > 1)
+      {
+        for (std::size_t t = 0; t < st.threadCounters.size(); ++t)
+        {
+          oss << "info string stats thread " << t;
+          append_counters(oss, st.threadCounters[t], st.elapsedMs);
+          oss << "\n";
+        }
+      }
+
+      const auto &dn = st.counters.depthNodes;
+      oss.precision(2);
+      oss << "info string stats ebf";
+      int first = 0, last = 0;
+      for (int d = 1; d < static_cast<int>(dn.size()); ++d)
+      {
+        if (!dn[d])
+          continue;
+        if (!first)
+          first = d;
+        else if (dn[d - 1])
+          oss << " d" << d << " " << static_cast<double>(dn[d]) / static_cast<double>(dn[d - 1]);
+        last = d;
+      }
+      if (first && last > first && dn[first])
+        oss << " avg " << std::pow(static_cast<double>(dn[last]) / static_cast<double>(dn[first]),
+                                   1.0 / (last - first));
+      oss << "\n";
+
+      std::cout << oss.str();
+      std::cout.flush();
+    }
+
+    // "<move>: <count>" per root move (divide), then the total.
+    static void print_perft(const engine::PerftResult &r, bool divide)
+    {
+      std::ostringstream oss;
+      if (divide)
+      {
+        for (const auto &d : r.divide)
+          oss << move_to_uci(d.move) << ": " << d.nodes << "\n";
+        oss << "\n";
+      }
+      const std::uint64_t nps = r.elapsedMs ? r.nodes * 1000 / r.elapsedMs : r.nodes;
+      oss << "Nodes searched: " << r.nodes << "\n";
+      oss << "info string perft time " << r.elapsedMs << " ms nps " << nps << "\n";
+      std::cout << oss.str();
+      std::cout.flush();
+    }
+
   }
 
   void UCI::showOptions()
@@ -150,7 +301,23 @@ namespace lilia::protocol::uci
 
     std::ostringstream oss;
     oss << "option name Hash type spin default " << c.ttSizeMb << " min 1 max 131072\n";
+    oss << "option name Hash Pages type combo default "
+        << (c.ttPages == engine::TTPagePolicy::Off       ? "Off"
+            : c.ttPages == engine::TTPagePolicy::HugeTLB ? "HugeTLB"
+                                                         : "Auto")
+        << " var Off var Auto var HugeTLB\n";
+    oss << "option name Hash Shared Name type string default "
+        << (c.ttSharedName.empty() ? "<empty>" : c.ttSharedName) << "\n";
+    oss << "option name Hash File type string default "
+        << (m_options.hashFile.empty() ? "<empty>" : m_options.hashFile) << "\n";
+    oss << "option name Pawn Hash type spin default " << c.pawnHashMb << " min 1 max 256\n";
+    oss << "option name Shared Pawn Hash type check default " << (c.sharedPawnHash ? "true" : "false")
+        << "\n";
+    oss << "option name Use Eval Hash type check default " << (c.useEvalHash ? "true" : "false")
+        << "\n";
+    oss << "option name Eval Hash type spin default " << c.evalHashMb << " min 1 max 1024\n";
     oss << "option name Threads type spin default " << c.threads << " min 0 max 64\n";
+    oss << "option name Pin Threads type check default " << (c.pinThreads ? "true" : "false") << "\n";
     oss << "option name Max Depth type spin default " << c.maxDepth << " min 1 max "
         << engine::MAX_PLY << "\n";
     oss << "option name Max Nodes type spin default " << c.maxNodes << " min 0 max 1000000000\n";
@@ -186,6 +353,16 @@ namespace lilia::protocol::uci
     oss << "option name Ponder type check default " << (m_options.ponder ? "true" : "false") << "\n";
     oss << "option name Move Overhead type spin default " << m_options.moveOverhead
         << " min 0 max 5000\n";
+    oss << "option name Search Stats type check default " << (m_options.searchStats ? "true" : "false")
+        << "\n";
+    oss << "option name Slider Attacks type combo default "
+        << (!m_options.sliderAttacks                                 ? "Auto"
+            : *m_options.sliderAttacks == chess::magic::Backend::Pext ? "Pext"
+                                                                      : "Magic")
+        << " var Auto var Magic var Pext\n";
+    oss << "option name EvalFile type string default "
+        << (m_options.evalFile.empty() ? "<empty>" : m_options.evalFile) << "\n";
+    oss << "option name Use NNUE type check default " << (m_options.useNnue ? "true" : "false") << "\n";
 
     std::cout << oss.str();
   }
@@ -235,6 +412,45 @@ namespace lilia::protocol::uci
         return;
       m_options.cfg.ttSizeMb = clampv(v, 1, 131072);
     }
+    else if (name == "Hash Pages")
+    {
+      if (ieq_lit(value, "off"))
+        m_options.cfg.ttPages = engine::TTPagePolicy::Off;
+      else if (ieq_lit(value, "hugetlb"))
+        m_options.cfg.ttPages = engine::TTPagePolicy::HugeTLB;
+      else if (ieq_lit(value, "auto"))
+        m_options.cfg.ttPages = engine::TTPagePolicy::Auto;
+    }
+    else if (name == "Hash Shared Name")
+    {
+      m_options.cfg.ttSharedName = (value == "<empty>") ? std::string{} : std::string(value);
+    }
+    else if (name == "Hash File")
+    {
+      m_options.hashFile = (value == "<empty>") ? std::string{} : std::string(value);
+    }
+    else if (name == "Pawn Hash")
+    {
+      int v = 0;
+      if (!parse_int(value, v))
+        return;
+      m_options.cfg.pawnHashMb = clampv(v, 1, 256);
+    }
+    else if (name == "Shared Pawn Hash")
+    {
+      m_options.cfg.sharedPawnHash = to_bool_sv(value);
+    }
+    else if (name == "Use Eval Hash")
+    {
+      m_options.cfg.useEvalHash = to_bool_sv(value);
+    }
+    else if (name == "Eval Hash")
+    {
+      int v = 0;
+      if (!parse_int(value, v))
+        return;
+      m_options.cfg.evalHashMb = clampv(v, 1, 1024);
+    }
     else if (name == "Threads")
     {
       int v = 0;
@@ -242,6 +458,31 @@ namespace lilia::protocol::uci
         return;
       m_options.cfg.threads = clampv(v, 0, 64);
     }
+    else if (name == "Search Stats")
+    {
+      m_options.searchStats = to_bool_sv(value);
+    }
+    else if (name == "Slider Attacks")
+    {
+      if (ieq_lit(value, "auto"))
+        m_options.sliderAttacks.reset();
+      else if (ieq_lit(value, "magic"))
+        m_options.sliderAttacks = chess::magic::Backend::Magic;
+      else if (ieq_lit(value, "pext"))
+        m_options.sliderAttacks = chess::magic::Backend::Pext;
+    }
+    else if (name == "EvalFile")
+    {
+      m_options.evalFile = (value == "<empty>") ? std::string{} : std::string(value);
+    }
+    else if (name == "Use NNUE")
+    {
+      m_options.useNnue = to_bool_sv(value);
+    }
+    else if (name == "Pin Threads")
+    {
+      m_options.cfg.pinThreads = to_bool_sv(value);
+    }
     else if (name == "Max Depth")
     {
       int v = 0;
@@ -363,6 +604,189 @@ namespace lilia::protocol::uci
     }
   }
 
+  engine::BotEngine &UCI::prepareEngine(const engine::EngineConfig &cfg)
+  {
+    using steady_clock = std::chrono::steady_clock;
+
+    if (m_engine && m_engineHashMb == cfg.ttSizeMb && m_enginePages == cfg.ttPages &&
+        m_engineShared == cfg.ttSharedName)
+    {
+      m_engine->setConfig(cfg);
+      return *m_engine;
+    }
+
+    const auto t0 = steady_clock::now();
+    const bool firstEngine = !m_engine;
+    if (!m_engine)
+      m_engine = std::make_unique<engine::BotEngine>(cfg);
+    else
+      m_engine->setConfig(cfg);
+    m_engineHashMb = cfg.ttSizeMb;
+    m_enginePages = cfg.ttPages;
+    m_engineShared = cfg.ttSharedName;
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(steady_clock::now() - t0).count();
+
+    std::ostringstream oss;
+    oss << "info string engine ready hash " << cfg.ttSizeMb << " MB ("
+        << engine::tt_page_mode_name(m_engine->engine().ttPageMode()) << ") in " << ms << " ms\n";
+    std::cout << oss.str();
+    std::cout.flush();
+    if (firstEngine)
+      reportSliderAttacks(m_options.sliderAttacks.has_value());
+    return *m_engine;
+  }
+
+  void UCI::applySliderAttacks()
+  {
+    namespace magic = chess::magic;
+
+    if (!m_options.sliderAttacks)
+    {
+      (void)magic::select_fastest_backend();
+      reportSliderAttacks(false);
+      return;
+    }
+    if (!magic::set_backend(*m_options.sliderAttacks))
+    {
+      std::cout << "info string slider attacks " << magic::backend_name(*m_options.sliderAttacks)
+                << " unavailable on this CPU/build, keeping " << magic::backend_name(magic::backend())
+                << "\n";
+      std::cout.flush();
+      return;
+    }
+    reportSliderAttacks(true);
+  }
+
+  void UCI::reportSliderAttacks(bool forced) const
+  {
+    namespace magic = chess::magic;
+
+    std::ostringstream oss;
+    oss << "info string slider attacks " << magic::backend_name(magic::backend());
+    const magic::BackendTiming t = magic::last_backend_timing();
+    if (forced)
+      oss << " (forced)";
+    else if (t.pextNs > 0.0)
+      oss << std::fixed << std::setprecision(2) << " (calibrated: magic " << t.magicNs << " ns, pext "
+          << t.pextNs << " ns)";
+    else
+      oss << " (pext unavailable)";
+    oss << "\n";
+    std::cout << oss.str();
+    std::cout.flush();
+  }
+
+  void UCI::applyEvaluation()
+  {
+    engine::nnue::set_enabled(m_options.useNnue);
+
+    std::ostringstream oss;
+    if (m_options.evalFile.empty())
+      engine::nnue::unload();
+    else if (m_options.evalFile != engine::nnue::loaded_path())
+    {
+      std::string err;
+      if (!engine::nnue::load(m_options.evalFile, err))
+      {
+        oss << "info string could not load EvalFile: " << err << "\n";
+        m_options.evalFile = engine::nnue::loaded_path(); // the option shows what is in use
+      }
+    }
+
+    oss << "info string evaluation ";
+    if (engine::nnue::active())
+      oss << "NNUE (" << engine::nnue::loaded_path() << ")";
+    else
+      oss << "handcrafted";
+    oss << "\n";
+    std::cout << oss.str();
+    std::cout.flush();
+  }
+
+  void UCI::startEngineJob(std::function<void(engine::BotEngine &)> work)
+  {
+    waitEngineJob();
+    m_jobStop.store(false, std::memory_order_release);
+
+    m_engineJob = std::async(std::launch::async, [this, work = std::move(work), cfg = m_options.toEngineConfig()]
+                             {
+      engine::BotEngine &eng = prepareEngine(cfg);
+      if (work)
+        work(eng); });
+  }
+
+  void UCI::saveOrLoadHash(bool load, std::string path)
+  {
+    using steady_clock = std::chrono::steady_clock;
+
+    if (path.empty())
+    {
+      std::cout << "info string no hash file (set option Hash File or pass a path)\n";
+      std::cout.flush();
+      return;
+    }
+    if (!load && !m_engine)
+    {
+      std::cout << "info string hash is empty, nothing to save\n";
+      std::cout.flush();
+      return;
+    }
+
+    const auto t0 = steady_clock::now();
+    bool ok = false;
+    try
+    {
+      engine::EngineConfig cfg = m_options.toEngineConfig();
+      if (load && !m_engine)
+        cfg.ttSizeMb = 1; // the file decides the size, don't allocate the configured Hash first
+      engine::BotEngine &eng = prepareEngine(cfg);
+      if (load && eng.engine().ttPageMode() == engine::TTPageMode::Shared)
+      {
+        std::cout << "info string hash is shared with other processes, not loading " << path << "\n";
+        std::cout.flush();
+        return;
+      }
+      ok = load ? eng.engine().loadHash(path) : eng.engine().saveHash(path);
+      if (ok && load)
+      {
+        // The table now has the file's size; keep Hash in sync so the next go doesn't resize it away.
+        m_options.cfg.ttSizeMb = eng.engine().getConfig().ttSizeMb;
+        m_engineHashMb = m_options.cfg.ttSizeMb;
+      }
+    }
+    catch (const std::exception &)
+    {
+      m_engine.reset();
+      m_engineHashMb = 0;
+    }
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(steady_clock::now() - t0).count();
+
+    if (ok)
+      std::cout << "info string " << (load ? "loaded hash from " : "saved hash to ") << path << " ("
+                << m_options.cfg.ttSizeMb << " MB) in " << ms << " ms\n";
+    else
+      std::cout << "info string could not " << (load ? "load hash from " : "save hash to ") << path << "\n";
+    std::cout.flush();
+  }
+
+  void UCI::waitEngineJob()
+  {
+    if (!m_engineJob.valid())
+      return;
+    try
+    {
+      m_engineJob.get();
+    }
+    catch (const std::exception &e)
+    {
+      std::cout << "info string hash setup failed: " << e.what() << "\n";
+      std::cout.flush();
+      m_engine.reset();
+      m_engineHashMb = 0;
+    }
+    m_perftRunning.store(false, std::memory_order_release); // also when prepareEngine threw
+  }
+
   int UCI::run()
   {
     engine::Engine::init();
@@ -376,6 +800,7 @@ namespace lilia::protocol::uci
 
     auto stopSearch = [&]()
     {
+      m_jobStop.store(true, std::memory_order_release); // a running perft job
       std::thread t;
       {
         std::lock_guard<std::mutex> lk(stateMutex);
@@ -392,21 +817,29 @@ namespace lilia::protocol::uci
     };
 
     auto startSearch = [&](chess::ChessGame gameCopy, engine::EngineConfig cfg, int depth,
-                           int thinkMillis)
+                           engine::TimeLimits limits)
     {
       stopSearch();
+      waitEngineJob();
+
+      engine::BotEngine &engine = prepareEngine(cfg);
+      auto infoStream = std::make_shared<InfoStream>();
+      engine.engine().setInfoCallback([infoStream](const engine::SearchInfo &in)
+                                      { infoStream->on_iteration(in); });
 
       {
         std::lock_guard<std::mutex> lk(stateMutex);
         cancelToken.store(false, std::memory_order_release);
         searchRunning = true;
 
-        searchThread = std::thread([game = std::move(gameCopy), cfg, depth, thinkMillis, this,
-                                    &cancelToken, &stateMutex, &searchRunning]() mutable
+        searchThread = std::thread([game = std::move(gameCopy), &engine, depth, limits,
+                                    printStats = m_options.searchStats, infoStream, &cancelToken,
+                                    &stateMutex, &searchRunning]() mutable
                                    {
-        lilia::engine::BotEngine engine(cfg);
-
-        auto res = engine.findBestMove(game, depth, thinkMillis, &cancelToken);
+        auto res = engine.findBestMove(game, depth, limits, &cancelToken);
+        infoStream->flush();
+        if (printStats)
+          print_search_stats(res.stats);
 
         chess::Move best = chess::Move{};
         if (res.bestMove.has_value()) best = *res.bestMove;
@@ -452,6 +885,19 @@ namespace lilia::protocol::uci
 
       if (cmd == "isready")
       {
+        // Do pending allocations (first engine, Hash change) now rather than on the next go.
+        bool idle = false;
+        {
+          std::lock_guard<std::mutex> lk(stateMutex);
+          idle = !searchRunning;
+        }
+        // A running perft answers like a search: at once, so stop can still be read.
+        if (idle && !m_perftRunning.load(std::memory_order_acquire))
+        {
+          waitEngineJob();
+          (void)prepareEngine(m_options.toEngineConfig());
+        }
+
         std::cout << "readyok\n";
         std::cout.flush();
         continue;
@@ -459,13 +905,56 @@ namespace lilia::protocol::uci
 
       if (cmd == "setoption")
       {
+        const std::size_t oldHash = m_options.cfg.ttSizeMb;
+        const engine::TTPagePolicy oldPages = m_options.cfg.ttPages;
+        const std::string oldShared = m_options.cfg.ttSharedName;
+        const auto oldSliders = m_options.sliderAttacks;
+        const std::string oldEvalFile = m_options.evalFile;
+        const bool oldUseNnue = m_options.useNnue;
         setOption(line);
+
+        // The net is global; positions pick the evaluation up at the next search.
+        if (m_options.evalFile != oldEvalFile || m_options.useNnue != oldUseNnue)
+        {
+          stopSearch();
+          waitEngineJob();
+          applyEvaluation();
+        }
+
+        // Table swap: nothing may be probing the arenas meanwhile. Re-sending Auto recalibrates.
+        if (m_options.sliderAttacks != oldSliders ||
+            (!m_options.sliderAttacks && line.find("Slider Attacks") != std::string::npos))
+        {
+          stopSearch();
+          waitEngineJob();
+          applySliderAttacks();
+        }
+
+        // Resize right away on the pool so the next isready/go finds the table ready.
+        if (m_options.cfg.ttSizeMb != oldHash || m_options.cfg.ttPages != oldPages ||
+            m_options.cfg.ttSharedName != oldShared)
+        {
+          stopSearch();
+          startEngineJob();
+        }
         continue;
       }
 
       if (cmd == "ucinewgame")
       {
         stopSearch();
+        startEngineJob([](engine::BotEngine &eng)
+                       {
+          using steady_clock = std::chrono::steady_clock;
+
+          const auto t0 = steady_clock::now();
+          eng.newGame();
+          const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(steady_clock::now() - t0).count();
+
+          std::ostringstream oss;
+          oss << "info string hash cleared in " << ms << " ms\n";
+          std::cout << oss.str();
+          std::cout.flush(); });
         m_game = chess::ChessGame{};
         m_game.setPosition(std::string{chess::constant::START_FEN});
         continue;
@@ -539,6 +1028,71 @@ namespace lilia::protocol::uci
         continue;
       }
 
+      // go perft <depth>             : divide + total (Stockfish-compatible)
+      // perft <depth> [divide] [hash <mb>] [nobulk]
+      // perft suite [maxDepth]          : standard positions against published counts
+      if ((cmd == "go" && tok.n >= 2 && tok[1] == "perft") || cmd == "perft")
+      {
+        stopSearch();
+
+        engine::PerftOptions opt;
+        opt.stop = &m_jobStop;
+
+        const size_t first = (cmd == "go") ? 2 : 1;
+        bool divide = (cmd == "go");
+        bool suite = false;
+        int depth = 0;
+        for (size_t i = first; i < tok.n; ++i)
+        {
+          if (tok[i] == "divide")
+            divide = true;
+          else if (tok[i] == "suite")
+            suite = true;
+          else if (tok[i] == "nobulk")
+            opt.bulk = false;
+          else if (tok[i] == "hash" && i + 1 < tok.n)
+            (void)parse_int(tok[++i], opt.hashMb);
+          else
+            (void)parse_int(tok[i], depth);
+        }
+        if (!suite && depth < 1)
+        {
+          std::cout << "info string perft needs a depth >= 1\n";
+          std::cout.flush();
+          continue;
+        }
+
+        // On the engine job so stop/quit are still read; Threads resolves as for a search.
+        m_perftRunning.store(true, std::memory_order_release);
+        startEngineJob([this, opt, divide, suite, depth, pos = m_game.getPositionRefForBot()](engine::BotEngine &eng) mutable
+                       {
+          struct Done
+          {
+            std::atomic<bool> &flag;
+            ~Done() { flag.store(false, std::memory_order_release); }
+          } done{m_perftRunning};
+
+          opt.threads = eng.engine().getConfig().threads;
+          if (suite)
+          {
+            std::ostringstream oss;
+            (void)engine::run_perft_suite(oss, opt, depth);
+            std::cout << oss.str();
+            std::cout.flush();
+            return;
+          }
+
+          const engine::PerftResult r = engine::perft(pos, depth, opt);
+          if (r.stopped)
+          {
+            std::cout << "info string perft stopped after " << r.elapsedMs << " ms\n";
+            std::cout.flush();
+            return;
+          }
+          print_perft(r, divide); });
+        continue;
+      }
+
       if (cmd == "go")
       {
         int depth = -1;
@@ -596,48 +1150,78 @@ namespace lilia::protocol::uci
 
         const int searchDepth = (depth > 0 ? depth : m_options.cfg.maxDepth);
 
-        constexpr int UCI_UNBOUNDED_MS = 1'000'000'000;
-
-        int thinkMillis = 0;
-        if (movetime > 0)
-        {
-          thinkMillis = movetime;
-        }
-        else if (infinite || (ponder && m_options.ponder))
-        {
-          thinkMillis = UCI_UNBOUNDED_MS;
-        }
-        else
+        // infinite / ponder: no clock, runs until stop or maxDepth
+        engine::TimeLimits limits;
+        if (!(infinite || (ponder && m_options.ponder)))
         {
           const auto gs = m_game.getGameState();
           const bool whiteToMove = (gs.sideToMove == chess::Color::White);
 
-          const int timeLeft = whiteToMove ? wtime : btime;
-          const int inc = whiteToMove ? winc : binc;
-
-          if (timeLeft >= 0)
-          {
-            if (movestogo > 0)
-              thinkMillis = timeLeft / std::max(1, movestogo);
-            else
-              thinkMillis = timeLeft / 30;
-
-            thinkMillis += inc;
-            thinkMillis -= m_options.moveOverhead;
-            if (thinkMillis < 0)
-              thinkMillis = 0;
-          }
-          else
-          {
-            thinkMillis = 0; // depth-only / no TC
-          }
+          limits.moveTime = movetime;
+          limits.time = whiteToMove ? wtime : btime;
+          limits.inc = whiteToMove ? winc : binc;
+          limits.movesToGo = movestogo;
+          limits.overhead = m_options.moveOverhead;
         }
 
         auto cfg = m_options.toEngineConfig();
         if (nodes > 0)
           cfg.maxNodes = nodes;
 
-        startSearch(std::move(gameCopy), cfg, searchDepth, thinkMillis);
+        startSearch(std::move(gameCopy), cfg, searchDepth, limits);
+        continue;
+      }
+
+      // bench [depth] [threads] [hashMb]: fixed-depth search over the embedded positions
+      if (cmd == "bench")
+      {
+        // A pending clear/resize or a stopping perft would share the pool and stdout with it.
+        stopSearch();
+        waitEngineJob();
+
+        engine::BenchOptions opt;
+        opt.pawnHashMb = m_options.cfg.pawnHashMb;
+        opt.sharedPawnHash = m_options.cfg.sharedPawnHash;
+        if (tok.n > 1)
+          (void)parse_int(tok[1], opt.depth);
+        if (tok.n > 2)
+          (void)parse_int(tok[2], opt.threads);
+        if (tok.n > 3)
+          (void)parse_int(tok[3], opt.hashMb);
+        (void)engine::run_bench(std::cout, opt);
+        continue;
+      }
+
+      if (cmd == "stats")
+      {
+        bool idle = false;
+        {
+          std::lock_guard<std::mutex> lk(stateMutex);
+          idle = !searchRunning;
+        }
+        // A perft is the engine job; waiting for it would stop reading stop/quit.
+        if (m_perftRunning.load(std::memory_order_acquire))
+        {
+          std::cout << "info string stats unavailable while perft runs\n";
+          std::cout.flush();
+          continue;
+        }
+        waitEngineJob();
+        if (!idle)
+          std::cout << "info string stats unavailable while searching\n";
+        else if (!m_engine)
+          std::cout << "info string stats unavailable, no search yet\n";
+        else
+          print_search_stats(m_engine->getLastSearchStats());
+        std::cout.flush();
+        continue;
+      }
+
+      if (cmd == "save_hash" || cmd == "load_hash")
+      {
+        stopSearch();
+        waitEngineJob();
+        saveOrLoadHash(cmd == "load_hash", tok.n > 1 ? join_tokens(tok, 1, tok.n) : m_options.hashFile);
         continue;
       }
 
@@ -660,6 +1244,7 @@ namespace lilia::protocol::uci
     }
 
     stopSearch();
+    waitEngineJob();
     return 0;
   }
 
@@ -0,0 +1,105 @@
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "lilia/chess/chess_game.hpp"
+#include "lilia/chess/move_generator.hpp"
+#include "lilia/chess/position.hpp"
+
+using namespace lilia;
+
+// MoveGenerator emits strictly legal moves. Walk the tree with the checked doMove: it must
+// accept every generated move, the tactical + quiet split must cover the full set, and the
+// leaf counts must match the published perft numbers.
+namespace
+{
+  constexpr int MAX_DEPTH = 8;
+
+  struct Walker
+  {
+    chess::Position &pos;
+    chess::MoveGenerator mg;
+    std::array<chess::StateInfo, MAX_DEPTH> st{};
+    std::array<std::vector<chess::Move>, MAX_DEPTH> moves{};
+    std::uint64_t rejected = 0;
+    std::uint64_t splitMismatches = 0;
+
+    explicit Walker(chess::Position &p) : pos(p) {}
+
+    std::uint64_t run(int depth, int ply)
+    {
+      if (depth == 0)
+        return 1;
+
+      std::vector<chess::Move> &list = moves[ply];
+      list.clear();
+      mg.generateLegalMoves(pos.getBoard(), pos.getState(), list);
+
+      std::array<chess::Move, chess::MAX_MOVES> split{};
+      chess::MoveBuffer tactical(split.data(), chess::MAX_MOVES);
+      int n = mg.generateTacticalMoves(pos.getBoard(), pos.getState(), tactical);
+      if (!pos.inCheck())
+      {
+        chess::MoveBuffer quiet(split.data() + n, chess::MAX_MOVES - n);
+        n += mg.generateQuietMoves(pos.getBoard(), pos.getState(), quiet);
+      }
+      if (n != static_cast<int>(list.size()))
+        ++splitMismatches;
+
+      std::uint64_t nodes = 0;
+      for (const chess::Move &m : list)
+      {
+        if (!pos.doMove(m, st[ply]))
+        {
+          ++rejected;
+          continue;
+        }
+        nodes += run(depth - 1, ply + 1);
+        pos.undoMove();
+      }
+      return nodes;
+    }
+  };
+
+  struct Case
+  {
+    const char *name;
+    const char *fen;
+    int depth;
+    std::uint64_t nodes;
+  };
+
+  constexpr Case CASES[] = {
+      {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4, 197281},
+      {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862},
+      // en passant out of and into discovered checks along the rank
+      {"cpw3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624},
+      // castling through attacked squares, promotions with capture
+      {"cpw4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467},
+      {"cpw4-mirror", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1", 3, 9467},
+      // underpromotions and checks from promoted pieces
+      {"cpw5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379},
+  };
+}
+
+int main()
+{
+  int failures = 0;
+  for (const Case &c : CASES)
+  {
+    chess::ChessGame game;
+    game.setPosition(c.fen);
+    Walker w(game.getPositionRefForBot());
+    const std::uint64_t nodes = w.run(c.depth, 0);
+
+    if (nodes != c.nodes || w.rejected != 0 || w.splitMismatches != 0)
+    {
+      std::cerr << c.name << " depth " << c.depth << ": " << nodes << " nodes (expected " << c.nodes
+                << "), " << w.rejected << " generated moves rejected by doMove, " << w.splitMismatches
+                << " tactical/quiet split mismatches\n";
+      ++failures;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <string>
+
+#include "lilia/chess/chess_game.hpp"
+#include "lilia/engine/endgame.hpp"
+#include "lilia/engine/eval.hpp"
+#include "lilia/engine/search_position.hpp"
+
+using namespace lilia;
+
+// Known KPK results through a bare Evaluator (no Engine::init(), so the bitbase has to come
+// from the Evaluator itself), for both colours and mirrored files, and the KBNK corner drive.
+namespace
+{
+  struct KpkCase
+  {
+    const char *fen;
+    bool win; // for the side with the pawn
+  };
+
+  constexpr KpkCase KPK_CASES[] = {
+      // King on the sixth in front of the pawn: won with either side to move.
+      {"4k3/8/4K3/4P3/8/8/8/8 w - - 0 1", true},
+      {"4k3/8/4K3/4P3/8/8/8/8 b - - 0 1", true},
+      {"2k5/8/2K5/2P5/8/8/8/8 w - - 0 1", true},
+      {"5k2/8/5K2/5P2/8/8/8/8 b - - 0 1", true},
+      // King one square ahead of the pawn: the opposition decides.
+      {"8/4k3/8/4K3/4P3/8/8/8 b - - 0 1", true},
+      {"8/4k3/8/4K3/4P3/8/8/8 w - - 0 1", false},
+      {"8/3k4/8/3K4/3P4/8/8/8 b - - 0 1", true},
+      {"8/3k4/8/3K4/3P4/8/8/8 w - - 0 1", false},
+      // Defending king in the corner of a rook pawn.
+      {"k7/8/8/8/P7/8/8/7K w - - 0 1", false},
+      {"7k/8/8/8/7P/8/8/K7 b - - 0 1", false},
+      // Pawn falls.
+      {"8/8/8/8/3kP3/8/8/K7 b - - 0 1", false},
+
+      // The same with colours swapped.
+      {"8/8/8/8/4p3/4k3/8/4K3 b - - 0 1", true},
+      {"8/8/8/8/4p3/4k3/8/4K3 w - - 0 1", true},
+      {"8/8/8/8/2p5/2k5/8/2K5 b - - 0 1", true},
+      {"8/8/8/8/5p2/5k2/8/5K2 w - - 0 1", true},
+      {"8/8/8/4p3/4k3/8/4K3/8 w - - 0 1", true},
+      {"8/8/8/4p3/4k3/8/4K3/8 b - - 0 1", false},
+      {"8/8/8/3p4/3k4/8/3K4/8 w - - 0 1", true},
+      {"8/8/8/3p4/3k4/8/3K4/8 b - - 0 1", false},
+      {"7k/8/8/p7/8/8/8/K7 b - - 0 1", false},
+      {"k7/8/8/7p/8/8/8/7K w - - 0 1", false},
+      {"k7/8/8/8/3Kp3/8/8/8 w - - 0 1", false},
+  };
+
+  // KBNK with the bare king in a corner; the bishop's colour decides which one is right.
+  struct KbnkCase
+  {
+    const char *right; // bare king in a corner of the bishop's colour
+    const char *wrong; // same pieces, bare king in the other corner on the same rank
+    bool whiteStrong;
+  };
+
+  constexpr KbnkCase KBNK_CASES[] = {
+      // Light bishop: h1 and a8.
+      {"8/1B6/4N3/3K4/8/8/8/7k b - - 0 1", "8/1B6/4N3/3K4/8/8/8/k7 b - - 0 1", true},
+      // Dark bishop: a1 and h8.
+      {"8/2B5/4N3/3K4/8/8/8/k7 b - - 0 1", "8/2B5/4N3/3K4/8/8/8/7k b - - 0 1", true},
+      // Black has the pieces, dark bishop.
+      {"7K/8/8/8/3k4/4n3/1b6/8 w - - 0 1", "K7/8/8/8/3k4/4n3/1b6/8 w - - 0 1", false},
+  };
+
+  int evaluate(const engine::Evaluator &eval, const char *fen)
+  {
+    chess::ChessGame game;
+    game.setPosition(fen);
+    engine::SearchPosition pos(game.getPositionRefForBot());
+    return eval.evaluate(pos);
+  }
+}
+
+int main()
+{
+  engine::Evaluator eval;
+  int failures = 0;
+
+  for (const KpkCase &c : KPK_CASES)
+  {
+    chess::ChessGame game;
+    game.setPosition(c.fen);
+    const chess::Position &p = game.getPositionRefForBot();
+    const chess::Color strong =
+        p.getBoard().getPieces(chess::Color::White, chess::PieceType::Pawn) ? chess::Color::White
+                                                                            : chess::Color::Black;
+
+    const bool win = engine::endgame::kpk_win(p.getBoard(), p.getState().sideToMove);
+    if (win != c.win)
+    {
+      std::cerr << c.fen << ": bitbase says " << (win ? "win" : "draw") << '\n';
+      ++failures;
+    }
+
+    // Draws are exact zeros; wins lean clearly towards the pawn's side.
+    const int score = evaluate(eval, c.fen);
+    const int own = strong == chess::Color::White ? score : -score;
+    if (c.win ? own < 200 : score != 0)
+    {
+      std::cerr << c.fen << ": evaluates to " << score << " but is a " << (c.win ? "win" : "draw")
+                << '\n';
+      ++failures;
+    }
+  }
+
+  for (const KbnkCase &c : KBNK_CASES)
+  {
+    const int right = evaluate(eval, c.right);
+    const int wrong = evaluate(eval, c.wrong);
+    // White's view: the side with the pieces must prefer the right corner.
+    if (c.whiteStrong ? right <= wrong : right >= wrong)
+    {
+      std::cerr << "KBNK corner: " << c.right << " -> " << right << ", " << c.wrong << " -> " << wrong
+                << '\n';
+      ++failures;
+    }
+  }
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lilia/chess/chess_game.hpp"
+#include "lilia/chess/move_generator.hpp"
+#include "lilia/engine/nnue.hpp"
+#include "lilia/engine/search_position.hpp"
+
+using namespace lilia;
+
+// Writes a net with random weights, then walks random games with SearchPosition and checks
+// that the incrementally updated accumulator equals a refresh from the board after every
+// make, legal make, null move and undo.
+namespace
+{
+  constexpr std::uint32_t SEED = 20240611u;
+  constexpr int WALKS_PER_POSITION = 100;
+  constexpr int MAX_WALK_PLY = 64;
+
+  constexpr const char *FENS[] = {
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+      "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+  };
+
+  // Same layout nnue::load() reads: header, feature transformer, then the three layers.
+  bool write_random_net(const std::string &path, std::mt19937 &rng)
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+
+    auto put = [&](const auto &v)
+    { out.write(reinterpret_cast<const char *>(&v), sizeof(v)); };
+    auto put_n = [&](auto type, std::size_t n, int lo, int hi)
+    {
+      std::uniform_int_distribution<int> dist(lo, hi);
+      for (std::size_t i = 0; i < n; ++i)
+        put(static_cast<decltype(type)>(dist(rng)));
+    };
+
+    out.write("LILNNUE1", 8);
+    put(std::uint32_t{1}); // version
+    put(std::uint32_t{1}); // HalfKP
+    put(std::uint32_t{engine::nnue::L1});
+    put(std::uint32_t{engine::nnue::L2});
+    put(std::uint32_t{engine::nnue::L3});
+
+    put_n(std::int16_t{}, engine::nnue::L1, -64, 64);
+    put_n(std::int16_t{}, std::size_t(engine::nnue::INPUTS) * engine::nnue::L1, -32, 32);
+    put_n(std::int32_t{}, engine::nnue::L2, -2048, 2048);
+    put_n(std::int8_t{}, std::size_t(engine::nnue::L2) * 2 * engine::nnue::L1, -64, 64);
+    put_n(std::int32_t{}, engine::nnue::L3, -2048, 2048);
+    put_n(std::int8_t{}, std::size_t(engine::nnue::L3) * engine::nnue::L2, -64, 64);
+    put_n(std::int32_t{}, 1, -2048, 2048);
+    put_n(std::int8_t{}, engine::nnue::L3, -64, 64);
+    return static_cast<bool>(out);
+  }
+
+  enum class Step : std::uint8_t
+  {
+    Move,
+    Null
+  };
+}
+
+int main()
+{
+  std::mt19937 rng(SEED);
+  const std::string path =
+      (std::filesystem::temp_directory_path() / ("lilia_nnue_test_" + std::to_string(SEED) + ".nnue")).string();
+  if (!write_random_net(path, rng))
+  {
+    std::cerr << "cannot write " << path << "\n";
+    return 1;
+  }
+
+  std::string err;
+  const bool loaded = engine::nnue::load(path, err);
+  std::filesystem::remove(path);
+  if (!loaded)
+  {
+    std::cerr << "load failed: " << err << "\n";
+    return 1;
+  }
+  engine::nnue::set_enabled(true);
+
+  int failures = 0;
+  chess::MoveGenerator mg;
+  std::vector<chess::Move> moves;
+
+  for (const char *fen : FENS)
+  {
+    chess::ChessGame game;
+    game.setPosition(fen);
+    engine::SearchPosition pos(game.getPositionRefForBot());
+    if (!pos.nnueAcc())
+    {
+      std::cerr << "SearchPosition did not pick up the loaded net\n";
+      return 1;
+    }
+
+    std::vector<Step> line;
+    std::uint64_t checks = 0, mismatches = 0;
+    auto check = [&]
+    {
+      engine::nnue::Accumulator fresh;
+      engine::nnue::refresh(fresh, pos.getBoard());
+      ++checks;
+      if (std::memcmp(fresh.v, pos.nnueAcc()->v, sizeof(fresh.v)) != 0)
+        ++mismatches;
+    };
+    auto undo = [&]
+    {
+      if (line.back() == Step::Null)
+        pos.undoNullMove();
+      else
+        pos.undoMove();
+      line.pop_back();
+      check();
+    };
+
+    // Each walk goes out to a random length, stepping back now and then, and unwinds to the
+    // root again so the root's castling and en passant moves keep being drawn.
+    for (int walk = 0; walk < WALKS_PER_POSITION; ++walk)
+    {
+      const int length = 1 + static_cast<int>(rng() % MAX_WALK_PLY);
+      while (static_cast<int>(line.size()) < length)
+      {
+        moves.clear();
+        mg.generateLegalMoves(pos.getBoard(), pos.getState(), moves);
+        if (moves.empty())
+          break;
+
+        const int roll = static_cast<int>(rng() % 16);
+        if (roll < 3 && !line.empty())
+        {
+          undo();
+          continue;
+        }
+
+        if (roll == 3 && !pos.inCheck() && (line.empty() || line.back() != Step::Null))
+        {
+          if (!pos.doNullMove())
+            break;
+          line.push_back(Step::Null);
+        }
+        else
+        {
+          const chess::Move m = moves[rng() % moves.size()];
+          if (!((roll & 1) ? pos.doLegalMove(m) : pos.doMove(m)))
+          {
+            std::cerr << fen << ": generated move rejected\n";
+            ++failures;
+            break;
+          }
+          line.push_back(Step::Move);
+        }
+        check();
+      }
+
+      while (!line.empty())
+        undo();
+    }
+
+    if (mismatches != 0)
+    {
+      std::cerr << fen << ": incremental accumulator differs from a refresh at " << mismatches
+                << " of " << checks << " steps\n";
+      ++failures;
+    }
+  }
+
+  engine::nnue::unload();
+  return failures == 0 ? 0 : 1;
+}
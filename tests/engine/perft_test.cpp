@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "lilia/chess/chess_game.hpp"
+#include "lilia/chess/move_generator.hpp"
+#include "lilia/engine/eval_acc.hpp"
+#include "lilia/engine/perft.hpp"
+#include "lilia/engine/search_position.hpp"
+
+using namespace lilia;
+
+// Position::doLegalMove and SearchPosition::doLegalMove skip the king-safety test, so the
+// published counts are the regression check for both make paths.
+namespace
+{
+  // Depth cap so the whole file runs in about a second.
+  constexpr int MAX_TEST_DEPTH = 4;
+  constexpr int SEARCH_POSITION_DEPTH = 3;
+
+  struct SearchWalker
+  {
+    engine::SearchPosition &pos;
+    chess::MoveGenerator mg;
+    std::uint64_t accMismatches = 0;
+
+    explicit SearchWalker(engine::SearchPosition &p) : pos(p) {}
+
+    std::uint64_t run(int depth)
+    {
+      engine::EvalAcc fresh;
+      fresh.build_from_board(pos.getBoard());
+      const engine::EvalAcc &acc = pos.evalAcc();
+      if (acc.mg != fresh.mg || acc.eg != fresh.eg || acc.phase != fresh.phase || acc.matKey != fresh.matKey)
+        ++accMismatches;
+
+      if (depth == 0)
+        return 1;
+
+      std::vector<chess::Move> moves;
+      mg.generateLegalMoves(pos.getBoard(), pos.getState(), moves);
+
+      std::uint64_t nodes = 0;
+      for (const chess::Move &m : moves)
+      {
+        if (!pos.doLegalMove(m))
+          return 0;
+        nodes += run(depth - 1);
+        pos.undoMove();
+      }
+      return nodes;
+    }
+  };
+}
+
+int main()
+{
+  int failures = 0;
+  auto report = [&](const engine::PerftCase &c, const char *what, int depth, std::uint64_t got)
+  {
+    std::cerr << c.name << " depth " << depth << " (" << what << "): " << got << " nodes, expected "
+              << c.counts[static_cast<std::size_t>(depth)] << "\n";
+    ++failures;
+  };
+
+  engine::PerftOptions variants[4];
+  variants[1].bulk = false;
+  variants[2].hashMb = 4;
+  variants[3].threads = 4;
+  const char *variantNames[4] = {"bulk", "no bulk", "hash", "threads"};
+
+  for (const engine::PerftCase &c : engine::perft_suite())
+  {
+    chess::ChessGame game;
+    game.setPosition(c.fen);
+    const chess::Position &root = game.getPositionRefForBot();
+
+    const int depth = std::min(c.depth, MAX_TEST_DEPTH);
+    const std::uint64_t expect = c.counts[static_cast<std::size_t>(depth)];
+    for (int v = 0; v < 4; ++v)
+    {
+      const engine::PerftResult r = engine::perft(root, depth, variants[v]);
+      std::uint64_t divided = 0;
+      for (const engine::PerftDivide &d : r.divide)
+        divided += d.nodes;
+      if (r.nodes != expect || divided != r.nodes)
+        report(c, variantNames[v], depth, r.nodes);
+    }
+
+    engine::SearchPosition spos(root);
+    SearchWalker w(spos);
+    const std::uint64_t nodes = w.run(SEARCH_POSITION_DEPTH);
+    if (nodes != c.counts[SEARCH_POSITION_DEPTH])
+      report(c, "SearchPosition", SEARCH_POSITION_DEPTH, nodes);
+    if (w.accMismatches != 0)
+    {
+      std::cerr << c.name << ": incremental EvalAcc differs from a rebuild at " << w.accMismatches
+                << " nodes\n";
+      ++failures;
+    }
+  }
+
+  return failures == 0 ? 0 : 1;
+}
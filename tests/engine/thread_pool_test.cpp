@@ -0,0 +1,153 @@
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lilia/engine/thread_pool.hpp"
+
+using namespace lilia;
+
+// parallel_for contracts: every index exactly once, calls from several outside threads at
+// the same time, nested calls from inside a worker, and exceptions.
+namespace
+{
+  constexpr int POOL_THREADS = 4;
+  constexpr int OUTSIDE_THREADS = 4;
+  constexpr int OUTSIDE_ROUNDS = 50;
+  constexpr int NESTED_ATTEMPTS = 100;
+
+  struct Counts
+  {
+    std::unique_ptr<std::atomic<int>[]> v;
+    std::size_t n;
+
+    explicit Counts(std::size_t size) : v(new std::atomic<int>[size]), n(size)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        v[i].store(0, std::memory_order_relaxed);
+    }
+
+    // Index of the first count that is not 1, or n.
+    std::size_t first_wrong() const
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        if (v[i].load(std::memory_order_relaxed) != 1)
+          return i;
+      return n;
+    }
+  };
+
+  bool once_each(engine::ThreadPool &pool, std::size_t n, std::size_t grain)
+  {
+    Counts c(n);
+    pool.parallel_for(0, n, [&](std::size_t i)
+                      { c.v[i].fetch_add(1, std::memory_order_relaxed); }, grain);
+    const std::size_t bad = c.first_wrong();
+    if (bad != n)
+    {
+      std::cerr << "size " << n << " grain " << grain << ": index " << bad << " ran "
+                << c.v[bad].load() << " times\n";
+      return false;
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  engine::ThreadPool &pool = engine::ThreadPool::instance(POOL_THREADS);
+  pool.maybe_resize(POOL_THREADS);
+  int failures = 0;
+
+  for (std::size_t n : {std::size_t{1}, std::size_t{2}, std::size_t{7}, std::size_t{64}, std::size_t{1000},
+                        std::size_t{100003}})
+    for (std::size_t grain : {std::size_t{0}, std::size_t{1}, std::size_t{3}, std::size_t{64}, std::size_t{5000}})
+      failures += !once_each(pool, n, grain);
+
+  // Several non-pool threads submitting at once; all their work goes through the injector.
+  {
+    std::atomic<int> wrong{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < OUTSIDE_THREADS; ++t)
+      threads.emplace_back([&, t]
+                           {
+        for (int r = 0; r < OUTSIDE_ROUNDS; ++r)
+          if (!once_each(pool, 997 + 101 * t, 1 + t))
+            wrong.fetch_add(1); });
+    for (auto &th : threads)
+      th.join();
+    failures += wrong.load();
+  }
+
+  // Nested parallel_for. Which thread runs an outer index is up to the scheduler, so repeat
+  // until a pool worker (not this thread) has run one of the nested calls.
+  {
+    const std::thread::id self = std::this_thread::get_id();
+    bool fromWorker = false;
+    for (int attempt = 0; attempt < NESTED_ATTEMPTS && !fromWorker; ++attempt)
+    {
+      constexpr std::size_t OUTER = 32, INNER = 500;
+      Counts c(OUTER * INNER);
+      std::atomic<bool> worker{false};
+      pool.parallel_for(0, OUTER, [&](std::size_t o)
+                        {
+        if (std::this_thread::get_id() != self)
+          worker.store(true, std::memory_order_relaxed);
+        pool.parallel_for(0, INNER, [&](std::size_t i)
+                          { c.v[o * INNER + i].fetch_add(1, std::memory_order_relaxed); }); });
+      if (c.first_wrong() != c.n)
+      {
+        std::cerr << "nested: index " << c.first_wrong() << " did not run exactly once\n";
+        ++failures;
+        break;
+      }
+      fromWorker = worker.load();
+    }
+    if (!fromWorker)
+    {
+      std::cerr << "nested: no worker ran a nested parallel_for in " << NESTED_ATTEMPTS << " attempts\n";
+      ++failures;
+    }
+  }
+
+  // The first exception comes back to the caller; indices not yet started are skipped.
+  {
+    constexpr std::size_t N = 1 << 16;
+    std::atomic<std::size_t> ran{0};
+    bool caught = false;
+    try
+    {
+      pool.parallel_for(0, N, [&](std::size_t i)
+                        {
+        if (i == 0)
+          throw std::runtime_error("index 0");
+        ran.fetch_add(1, std::memory_order_relaxed);
+        for (volatile int spin = 0; spin < 200; spin = spin + 1)
+        {
+        } });
+    }
+    catch (const std::runtime_error &e)
+    {
+      caught = std::string(e.what()) == "index 0";
+    }
+    if (!caught)
+    {
+      std::cerr << "exception: not rethrown to the caller\n";
+      ++failures;
+    }
+    if (ran.load() >= N - 1)
+    {
+      std::cerr << "exception: all " << ran.load() << " remaining indices still ran\n";
+      ++failures;
+    }
+
+    // The pool is still usable afterwards.
+    failures += !once_each(pool, 1000, 1);
+  }
+
+  return failures == 0 ? 0 : 1;
+}